@@ -0,0 +1,153 @@
+--
+-- Price overrides: items (or ranges of items) sold at a fixed buyout range instead of their vendor price.
+-- The buyout is per unit, in copper; the starting bid is a percentage of the buyout.
+--
+
+DROP TABLE IF EXISTS `mod_auctionhousebot_price_overrides`;
+CREATE TABLE `mod_auctionhousebot_price_overrides` (
+  `itemstart` mediumint(8) unsigned NOT NULL COMMENT 'First item entry of the range.',
+  `itemend` mediumint(8) unsigned NOT NULL COMMENT 'Last item entry of the range; equal to itemstart for a single item.',
+  `minbuyout` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Minimum buyout price (copper).',
+  `maxbuyout` int(10) unsigned NOT NULL DEFAULT '0' COMMENT 'Maximum buyout price (copper).',
+  `minbidratio` int(10) unsigned NOT NULL DEFAULT '70' COMMENT 'Minimum starting bid as a percentage of the buyout.',
+  `maxbidratio` int(10) unsigned NOT NULL DEFAULT '80' COMMENT 'Maximum starting bid as a percentage of the buyout.',
+  `comment` varchar(255) DEFAULT NULL,
+  PRIMARY KEY (`itemstart`)
+) ENGINE=MyISAM DEFAULT CHARSET=utf8;
+
+--
+-- Price overrides default values
+--
+
+INSERT INTO `mod_auctionhousebot_price_overrides` (`itemstart`, `itemend`, `minbuyout`, `maxbuyout`, `minbidratio`, `maxbidratio`, `comment`)
+VALUES
+(33350, 33350, 12500000, 25000000, 70, 80, 'Other BoE'),
+(36766, 36767, 1000000, 2000000, 70, 80, 'Gems'),
+(36919, 36919, 1000000, 2000000, 70, 80, 'Gems'),
+(36922, 36922, 1000000, 2000000, 70, 80, 'Gems'),
+(36925, 36925, 1000000, 2000000, 70, 80, 'Gems'),
+(36928, 36928, 1000000, 2000000, 70, 80, 'Gems'),
+(36931, 36931, 1000000, 2000000, 70, 80, 'Gems'),
+(36934, 36934, 1000000, 2000000, 70, 80, 'Gems'),
+(37835, 37835, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39194, 39194, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39235, 39235, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39283, 39283, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39310, 39310, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39472, 39472, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39717, 39717, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39733, 39733, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(39762, 39762, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40111, 40182, 1000000, 2000000, 70, 80, 'Gems'),
+(40187, 40187, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40206, 40206, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40246, 40246, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40270, 40270, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40282, 40282, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40302, 40302, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40305, 40305, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40338, 40338, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40347, 40347, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40362, 40362, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40426, 40426, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40439, 40439, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40474, 40474, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40553, 40553, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40558, 40558, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(40733, 40741, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41168, 41168, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41257, 41257, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41383, 41384, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41386, 41388, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41391, 41392, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41394, 41394, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(41609, 41610, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42100, 42103, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42111, 42111, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42113, 42113, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42142, 42146, 1000000, 2000000, 70, 80, 'Gems'),
+(42148, 42158, 1000000, 2000000, 70, 80, 'Gems'),
+(42435, 42435, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42508, 42508, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42642, 42647, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(42987, 42987, 28000000, 37000000, 70, 80, 'Crafted head/chest/legs ilvl 245'),
+(42988, 42988, 12500000, 25000000, 70, 80, 'Other BoE'),
+(42989, 42990, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43458, 43459, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43461, 43461, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43469, 43469, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43481, 43481, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43484, 43484, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43495, 43495, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43502, 43502, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43565, 43566, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43573, 43573, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43582, 43588, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43590, 43595, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(43611, 43613, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(44066, 44066, 1000000, 2000000, 70, 80, 'Gems'),
+(44253, 44255, 12500000, 25000000, 70, 80, 'Other BoE'),
+(44308, 44313, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(44504, 44504, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(44926, 44926, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(44930, 44931, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(44948, 44948, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45085, 45085, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45107, 45107, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45141, 45141, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45167, 45167, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45237, 45237, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45247, 45247, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45274, 45274, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45291, 45291, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45301, 45301, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45316, 45316, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45322, 45322, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45435, 45435, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45450, 45450, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45468, 45468, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45480, 45480, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45493, 45493, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45504, 45504, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45550, 45567, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45680, 45680, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45704, 45704, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45709, 45709, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45859, 45859, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45862, 45862, 1000000, 2000000, 70, 80, 'Gems'),
+(45874, 45874, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45879, 45883, 1000000, 2000000, 70, 80, 'Gems'),
+(45927, 45927, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45975, 45975, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(45987, 45987, 1000000, 2000000, 70, 80, 'Gems'),
+(46009, 46009, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(46970, 46970, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47089, 47089, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47105, 47105, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47149, 47149, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47223, 47223, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47257, 47257, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47278, 47278, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47291, 47291, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47297, 47297, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47315, 47315, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47570, 47577, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47579, 47588, 12500000, 25000000, 70, 80, 'Other BoE'),
+(47589, 47606, 28000000, 37000000, 70, 80, 'Crafted head/chest/legs ilvl 245'),
+(48663, 48663, 8000000, 12000000, 70, 80, 'Item level 200 to 245'),
+(49110, 49110, 1000000, 2000000, 70, 80, 'Gems'),
+(49890, 49907, 12500000, 25000000, 70, 80, 'Other BoE'),
+(49967, 49967, 12500000, 25000000, 70, 80, 'Other BoE'),
+(49994, 49994, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50001, 50001, 28000000, 37000000, 70, 80, 'Crafted head/chest/legs ilvl 245'),
+(50015, 50015, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50020, 50020, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50038, 50038, 28000000, 37000000, 70, 80, 'Crafted head/chest/legs ilvl 245'),
+(50069, 50069, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50175, 50175, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50182, 50182, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50444, 50444, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50447, 50447, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50449, 50453, 12500000, 25000000, 70, 80, 'Other BoE'),
+(50472, 50472, 12500000, 25000000, 70, 80, 'Other BoE'),
+(52252, 52252, 8000000, 12000000, 70, 80, 'Item level 200 to 245');
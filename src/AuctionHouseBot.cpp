@@ -17,6 +17,8 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <chrono>
+
 #include "ObjectMgr.h"
 #include "AuctionHouseMgr.h"
 #include "Config.h"
@@ -27,6 +29,8 @@
 
 #include "AuctionHouseBot.h"
 #include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotPlanner.h"
+#include "AuctionHouseBotSampler.h"
 
 using namespace std;
 
@@ -35,109 +39,55 @@ AuctionHouseBot::AuctionHouseBot(uint32 account, uint32 id)
     _account        = account;
     _id             = id;
 
-    _lastrun_a_sec  = time(NULL);
-    _lastrun_h_sec  = time(NULL);
-    _lastrun_n_sec  = time(NULL);
-
     _allianceConfig = NULL;
     _hordeConfig    = NULL;
     _neutralConfig  = NULL;
+
+    _updateCount    = 0;
+    _updateTime     = 0;
+
+    _listingCommits    = 0;
+    _listingStatements = 0;
+    _listingCount      = 0;
+    _listingStatsStart = std::chrono::steady_clock::now();
 }
 
 AuctionHouseBot::~AuctionHouseBot()
 {
-    // Nothing
+    //
+    // The player refers to the session, so it must go first
+    //
+
+    _AHBplayer.reset();
+    _session.reset();
 }
 
-uint32 AuctionHouseBot::getElement(std::set<uint32> set, int index, uint32 botId, uint32 maxDup, AuctionHouseObject* auctionHouse)
+uint32 AuctionHouseBot::getPlan(AHBConfig* config, uint32 category, uint32 botId, uint32 maxDup, AHBListingPlan& plan)
 {
-    std::set<uint32>::iterator it = set.begin();
-    std::advance(it, index);
+    //
+    // Take a listing prepared by the planner, or make one here if it fell behind
+    //
 
-    if (maxDup > 0)
+    if (!gPlanner.Pop(config->GetAHID(), category, plan))
     {
-        uint32 noStacks = 0;
-
-        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
-        {
-            AuctionEntry* Aentry = itr->second;
-
-            if (Aentry->owner.GetCounter() == botId)
-            {
-                if (*it == Aentry->item_template)
-                {
-                    noStacks++;
-                }
-            }
-        }
+        AHBPlanSettings settings;
+        settings.Load(config);
 
-        if (noStacks >= maxDup)
+        if (!AHBPlanner::MakePlan(settings, category, plan))
         {
-            return 0;
+            return AHB_CATALOG_NO_ROW;
         }
     }
 
-    return *it;
-}
-
-uint32 AuctionHouseBot::getStackCount(AHBConfig* config, uint32 max)
-{
-    if (max == 1)
-    {
-        return 1;
-    }
-
-    // 
-    // Organize the stacks in a pseudo random way
-    // 
-
-    if (config->DivisibleStacks)
+    if (maxDup > 0)
     {
-        uint32 ret = 0;
-
-        if (max % 5 == 0) // 5, 10, 15, 20
-        {
-            ret = urand(1, 4) * 5;
-        }
-
-        if (max % 4 == 0) // 4, 8, 12, 16
+        if (config->GetBotListings(botId, config->Catalog->GetItemId(plan.row)) >= maxDup)
         {
-            ret = urand(1, 4) * 4;
+            return AHB_CATALOG_NO_ROW;
         }
-
-        if (max % 3 == 0) // 3, 6, 9, 18
-        {
-            ret = urand(1, 3) * 3;
-        }
-
-        if (ret > max)
-        {
-            ret = max;
-        }
-
-        return ret;
     }
 
-    // 
-    // Totally random
-    // 
-
-    return urand(1, max);
-}
-
-uint32 AuctionHouseBot::getElapsedTime(uint32 timeClass)
-{
-    switch (timeClass)
-    {
-    case 2:
-        return urand(1, 5) * 600;   // SHORT = In the range of one hour
-
-    case 1:
-        return urand(1, 23) * 3600; // MEDIUM = In the range of one day
-
-    default:
-        return urand(1, 3) * 86400; // LONG = More than one day but less than three
-    }
+    return plan.row;
 }
 
 uint32 AuctionHouseBot::getNofAuctions(AHBConfig* config, AuctionHouseObject* auctionHouse, ObjectGuid guid)
@@ -152,29 +102,17 @@ uint32 AuctionHouseBot::getNofAuctions(AHBConfig* config, AuctionHouseObject* au
     }
 
     //
-    // Just the one handled by the bot
+    // Just the one handled by the bot, kept up to date by the auction house hooks
     //
 
-    uint32 count = 0;
-
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
-    {
-        AuctionEntry* Aentry = itr->second;
-
-        if (guid == Aentry->owner)
-        {
-            count++;
-        }
-    }
-
-    return count;
+    return config->GetBotAuctions(guid.GetCounter());
 }
 
 // =============================================================================
 // This routine performs the bidding operations for the bot
 // =============================================================================
 
-void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* session)
+void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* session, std::shared_ptr<AHBBuyerPrefetch> const& prefetch)
 {
     //
     // Check if disabled
@@ -186,33 +124,66 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
     }
 
     //
-    // Retrieve items not owner by the bot and not bought by the bot
+    // Retrieve the auctions the bot may bid on
     //
 
-    QueryResult result = CharacterDatabase.Query("SELECT id FROM auctionhouse WHERE itemowner<>{} AND buyguid<>{}", _id, _id);
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
+    std::vector<uint32> possibleBids;
 
-    if (!result)
+    if (config->BuyerCandidateSource == AHB_CANDIDATES_DATABASE && prefetch)
     {
-        return;
-    }
+        //
+        // Use the auctions fetched during the previous interval, and ask already for the ones of the next.
+        // The first query is issued when the bots start; nothing is bid on while its result is not there.
+        //
 
-    if (result->GetRowCount() == 0)
-    {
-        return;
-    }
+        possibleBids.swap(prefetch->auctions);
 
-    //
-    // Fetches content of selected AH to look for possible bids
-    //
+        PrefetchBuyCandidates(config, prefetch);
 
-    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
-    std::set<uint32>    possibleBids;
+        //
+        // Keep as many different random auctions as the bids attempts configured, among the ones this bot does not
+        // lead already: the query may have been issued by another bot
+        //
+
+        uint32 count = config->GetBidsPerInterval();
+        uint32 kept  = 0;
+        uint32 size  = uint32(possibleBids.size());
+
+        for (uint32 i = 0; i < size && kept < count; ++i)
+        {
+            std::swap(possibleBids[i], possibleBids[urand(i, size - 1)]);
+
+            AuctionEntry* auction = auctionHouse->GetAuction(possibleBids[i]);
+
+            if (auction && auction->bidder.GetCounter() != _id)
+            {
+                possibleBids[kept++] = possibleBids[i];
+            }
+        }
 
-    do
+        possibleBids.resize(kept);
+    }
+    else
     {
-        uint32 tmpdata = result->Fetch()->Get<uint32>();
-        possibleBids.insert(tmpdata);
-    } while (result->NextRow());
+        //
+        // Choose among the auctions of the players, kept up to date by the auction house hooks, as many different
+        // auctions as the bids attempts configured: the best deals, the ones about to expire or random ones
+        //
+
+        if (config->BuyerStrategy == AHB_BUYER_BEST_DEAL)
+        {
+            config->DrawBestDeals(config->GetBidsPerInterval(), _id, possibleBids);
+        }
+        else if (config->BuyerStrategy == AHB_BUYER_EXPIRING)
+        {
+            config->DrawExpiring(config->GetBidsPerInterval(), _id, possibleBids);
+        }
+        else
+        {
+            config->GetBuyCandidates().Draw(config->GetBidsPerInterval(), possibleBids);
+        }
+    }
 
     //
     // If it's not possible to bid stop here
@@ -229,29 +200,27 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
     }
 
     //
-    // Perform the operation for a maximum amount of bids attempts configured
+    // All the bids and buyouts of the interval are saved with a single transaction
     //
 
-    for (uint32 count = 1; count <= config->GetBidsPerInterval(); ++count)
-    {
-        //
-        // Choose a random auction from possible auctions
-        //
+    CharacterDatabaseTransaction trans   = CharacterDatabase.BeginTransaction();
+    uint32                       bids    = 0;
+    uint32                       buyouts = 0;
 
-        uint32 randBid = urand(0, possibleBids.size() - 1);
-
-        std::set<uint32>::iterator it = possibleBids.begin();
-        std::advance(it, randBid);
+    for (uint32 auctionId : possibleBids)
+    {
+        AuctionEntry* auction = auctionHouse->GetAuction(auctionId);
 
-        AuctionEntry* auction = auctionHouse->GetAuction(*it);
+        if (!auction)
+        {
+            continue;
+        }
 
         //
-        // Prevent to bid again on the same auction
+        // Skip the auctions where the bot is already the highest bidder
         //
 
-        possibleBids.erase(randBid);
-
-        if (!auction)
+        if (auction->bidder.GetCounter() == _id)
         {
             continue;
         }
@@ -266,27 +235,21 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
         }
 
         //
-        // Get the item information
+        // Look up the value of the item for the buyer
         //
 
-        Item* pItem = sAuctionMgr->GetAItem(auction->item_guid);
+        AHBBuyerValuation const& valuation = config->GetBuyerValuation(auction->item_template);
 
-        if (!pItem)
+        if (valuation.excluded)
         {
             if (config->DebugOutBuyer)
             {
-                LOG_ERROR("module", "AHBot [{}]: item {} doesn't exist, perhaps bought already?", _id, auction->item_guid.ToString());
+                LOG_INFO("module", "AHBot [{}]: item {} is not bought", _id, auction->item_template);
             }
 
             continue;
         }
 
-        //
-        // Get the item prototype
-        //
-
-        ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
-
         //
         // Check which price we have to use, startbid or if it is bidded already
         //
@@ -313,57 +276,11 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
         // Check that bid has an acceptable value and take bid based on vendorprice, stacksize and quality
         //
 
-        if (config->BuyMethod)
-        {
-            if (prototype->Quality <= AHB_MAX_QUALITY)
-            {
-                if (currentprice < prototype->SellPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality))
-                {
-                    bidMax = prototype->SellPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality);
-                }
-            }
-            else
-            {
-                if (config->DebugOutBuyer)
-                {
-                    LOG_ERROR("module", "AHBot [{}]: Quality {} not Supported", _id, prototype->Quality);
-                }
+        uint64 stackValue = valuation.maxUnitBid * auction->itemCount;
 
-                continue;
-            }
-        }
-        else
+        if (currentprice < stackValue)
         {
-            if (prototype->Quality <= AHB_MAX_QUALITY)
-            {
-                if (currentprice < prototype->BuyPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality))
-                {
-                    bidMax = prototype->BuyPrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality);
-                }
-            }
-            else
-            {
-                if (config->DebugOutBuyer)
-                {
-                    LOG_ERROR("module", "AHBot [{}]: Quality {} not Supported", _id, prototype->Quality);
-                }
-
-                continue;
-            }
-        }
-
-        //
-        // Recalculate the bid depending on the type of the item
-        //
-
-        switch (prototype->Class)
-        {
-            // ammo
-        case 6:
-            bidMax = 0;
-            break;
-        default:
-            break;
+            bidMax = stackValue;
         }
 
         //
@@ -413,14 +330,23 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
             LOG_INFO("module", "AHBot [{}]: Bid Price: {}"        , _id, bidprice);
             LOG_INFO("module", "AHBot [{}]: Item GUID: {}"        , _id, auction->item_guid.ToString());
             LOG_INFO("module", "AHBot [{}]: Item Template: {}"    , _id, auction->item_template);
-            LOG_INFO("module", "AHBot [{}]: Item Info:");
-            LOG_INFO("module", "AHBot [{}]: Item ID: {}"          , _id, prototype->ItemId);
-            LOG_INFO("module", "AHBot [{}]: Buy Price: {}"        , _id, prototype->BuyPrice);
-            LOG_INFO("module", "AHBot [{}]: Sell Price: {}"       , _id, prototype->SellPrice);
-            LOG_INFO("module", "AHBot [{}]: Bonding: {}"          , _id, prototype->Bonding);
-            LOG_INFO("module", "AHBot [{}]: Quality: {}"          , _id, prototype->Quality);
-            LOG_INFO("module", "AHBot [{}]: Item Level: {}"       , _id, prototype->ItemLevel);
-            LOG_INFO("module", "AHBot [{}]: Ammo Type: {}"        , _id, prototype->AmmoType);
+            LOG_INFO("module", "AHBot [{}]: Stack Size: {}"       , _id, auction->itemCount);
+            LOG_INFO("module", "AHBot [{}]: Max Unit Bid: {}"     , _id, valuation.maxUnitBid);
+
+            ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
+
+            if (prototype)
+            {
+                LOG_INFO("module", "AHBot [{}]: Item Info:"           , _id);
+                LOG_INFO("module", "AHBot [{}]: Item ID: {}"          , _id, prototype->ItemId);
+                LOG_INFO("module", "AHBot [{}]: Buy Price: {}"        , _id, prototype->BuyPrice);
+                LOG_INFO("module", "AHBot [{}]: Sell Price: {}"       , _id, prototype->SellPrice);
+                LOG_INFO("module", "AHBot [{}]: Bonding: {}"          , _id, prototype->Bonding);
+                LOG_INFO("module", "AHBot [{}]: Quality: {}"          , _id, prototype->Quality);
+                LOG_INFO("module", "AHBot [{}]: Item Level: {}"       , _id, prototype->ItemLevel);
+                LOG_INFO("module", "AHBot [{}]: Ammo Type: {}"        , _id, prototype->AmmoType);
+            }
+
             LOG_INFO("module", "-------------------------------------------------");
         }
 
@@ -444,10 +370,7 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
                     // Mail to last bidder and return their money
                     //
         
-                    auto trans = CharacterDatabase.BeginTransaction();
-        
                     sAuctionMgr->SendAuctionOutbiddedMail(auction, bidprice, session->GetPlayer(), trans);
-                    CharacterDatabase.CommitTransaction  (trans);
                 }
             }
         
@@ -458,7 +381,21 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
             // Save the auction into database
             //
         
-            CharacterDatabase.Execute("UPDATE auctionhouse SET buyguid = '{}', lastbid = '{}' WHERE id = '{}'", auction->bidder.GetCounter(), auction->bid, auction->Id);
+            CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AUCTION_BID);
+
+            stmt->SetData(0, auction->bidder.GetCounter());
+            stmt->SetData(1, auction->bid);
+            stmt->SetData(2, auction->Id);
+
+            trans->Append(stmt);
+
+            //
+            // Leading the auction now, it is left out of the draws until a player outbids the bot
+            //
+
+            config->RemoveBuyCandidate(auction->Id);
+
+            bids++;
         }
         else
         {
@@ -468,8 +405,6 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
             // Perform the buyout
             //
 
-            auto trans = CharacterDatabase.BeginTransaction();
-
             if ((auction->bidder) && (AHBplayer->GetGUID() != auction->bidder))
             {
                 //
@@ -495,10 +430,7 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
 
             auction->DeleteFromDB(trans);
 
-            sAuctionMgr->RemoveAItem   (auction->item_guid);
-            auctionHouse->RemoveAuction(auction);
-
-            CharacterDatabase.CommitTransaction(trans);
+            buyouts++;
         }
 
         //
@@ -509,13 +441,37 @@ void AuctionHouseBot::Buy(Player* AHBplayer, AHBConfig* config, WorldSession* se
         {
             if (bought)
             {
-                LOG_INFO("module", "AHBot [{}]: Bought , id={}, ah={}, item={}, start={}, current={}, buyout={}", _id, prototype->ItemId, auction->GetHouseId(), auction->item_template, auction->startbid, currentprice, auction->buyout);
+                LOG_INFO("module", "AHBot [{}]: Bought , id={}, ah={}, item={}, start={}, current={}, buyout={}", _id, auction->Id, auction->GetHouseId(), auction->item_template, auction->startbid, currentprice, auction->buyout);
             }
             else
             {
-                LOG_INFO("module", "AHBot [{}]: New bid, id={}, ah={}, item={}, start={}, current={}, buyout={}", _id, prototype->ItemId, auction->GetHouseId(), auction->item_template, auction->startbid, currentprice, auction->buyout);
+                LOG_INFO("module", "AHBot [{}]: New bid, id={}, ah={}, item={}, start={}, current={}, buyout={}", _id, auction->Id, auction->GetHouseId(), auction->item_template, auction->startbid, currentprice, auction->buyout);
             }
         }
+
+        //
+        // The auction is deleted when removed from the auction house, so this comes last
+        //
+
+        if (bought)
+        {
+            sAuctionMgr->RemoveAItem   (auction->item_guid);
+            auctionHouse->RemoveAuction(auction);
+        }
+    }
+
+    if (config->TraceBuyer)
+    {
+        LOG_INFO("module", "AHBot [{}]: auctionhouse {}, candidates={}, bids={}, buyouts={}, statements={}", _id, config->GetAHID(), possibleBids.size(), bids, buyouts, trans->GetSize());
+    }
+
+    //
+    // Nothing to save when every candidate was skipped
+    //
+
+    if (trans->GetSize())
+    {
+        CharacterDatabase.CommitTransaction(trans);
     }
 }
 
@@ -564,7 +520,16 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
         return;
     }
 
-    auctionHouse->Update();
+    AHBSellProgress& progress = _sellProgress[config->GetAHID()];
+
+    //
+    // Expired auctions are only cleared when a new cycle starts, not when resuming one
+    //
+
+    if (progress.pending == 0)
+    {
+        auctionHouse->Update();
+    }
 
     // 
     // Check if we are clear to proceed
@@ -575,74 +540,97 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
     uint32 auctions = getNofAuctions(config, auctionHouse, AHBplayer->GetGUID());
     uint32 items    = 0;
 
-    if (auctions >= minItems)
+    if (progress.pending == 0)
     {
-        aboveMin = true;
+        //
+        // A new cycle
+        //
 
-        if (config->DebugOutSeller)
+        if (auctions >= minItems)
         {
-            LOG_ERROR("module", "AHBot [{}]: Auctions above minimum", _id);
-        }
+            aboveMin = true;
 
-        return;
-    }
+            if (config->DebugOutSeller)
+            {
+                LOG_ERROR("module", "AHBot [{}]: Auctions above minimum", _id);
+            }
 
-    if (auctions >= maxItems)
-    {
-        aboveMax = true;
+            endRefill(config, progress);
+            return;
+        }
 
-        if (config->DebugOutSeller)
+        if (auctions >= maxItems)
         {
-            LOG_ERROR("module", "AHBot [{}]: Auctions at or above maximum", _id);
+            aboveMax = true;
+
+            if (config->DebugOutSeller)
+            {
+                LOG_ERROR("module", "AHBot [{}]: Auctions at or above maximum", _id);
+            }
+
+            endRefill(config, progress);
+            return;
         }
 
-        return;
-    }
+        if ((maxItems - auctions) >= config->ItemsPerCycle)
+        {
+            progress.pending = config->ItemsPerCycle;
+        }
+        else
+        {
+            progress.pending = (maxItems - auctions);
+        }
 
-    if ((maxItems - auctions) >= config->ItemsPerCycle)
-    {
-        items = config->ItemsPerCycle;
+        if (!progress.refilling)
+        {
+            progress.refilling    = true;
+            progress.refillTicks  = 0;
+            progress.refillListed = 0;
+            progress.refillStart  = std::chrono::steady_clock::now();
+        }
     }
-    else
+    else if (auctions >= maxItems)
     {
-        items = (maxItems - auctions);
+        //
+        // The rest of an interrupted cycle is no longer needed
+        //
+
+        progress.pending = 0;
+        return;
     }
 
+    items = minValue(progress.pending, maxItems - auctions);
+
+    progress.refillTicks++;
+
+    //
+    // Stop listing when the time budget for this update runs out; what is left is done on the next one
+    //
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(config->SellBudgetMicroseconds);
+
     // 
-    // Retrieve the configuration for this run
+    // Retrieve the configuration for this run: every category is weighted by the amount of items it still misses
     // 
 
-    uint32 greyTGcount   = config->GetMaximum(AHB_GREY_TG);
-    uint32 whiteTGcount  = config->GetMaximum(AHB_WHITE_TG);
-    uint32 greenTGcount  = config->GetMaximum(AHB_GREEN_TG);
-    uint32 blueTGcount   = config->GetMaximum(AHB_BLUE_TG);
-    uint32 purpleTGcount = config->GetMaximum(AHB_PURPLE_TG);
-    uint32 orangeTGcount = config->GetMaximum(AHB_ORANGE_TG);
-    uint32 yellowTGcount = config->GetMaximum(AHB_YELLOW_TG);
-
-    uint32 greyIcount    = config->GetMaximum(AHB_GREY_I);
-    uint32 whiteIcount   = config->GetMaximum(AHB_WHITE_I);
-    uint32 greenIcount   = config->GetMaximum(AHB_GREEN_I);
-    uint32 blueIcount    = config->GetMaximum(AHB_BLUE_I);
-    uint32 purpleIcount  = config->GetMaximum(AHB_PURPLE_I);
-    uint32 orangeIcount  = config->GetMaximum(AHB_ORANGE_I);
-    uint32 yellowIcount  = config->GetMaximum(AHB_YELLOW_I);
-
-    uint32 greyTGoods    = config->GetItemCounts(AHB_GREY_TG);
-    uint32 whiteTGoods   = config->GetItemCounts(AHB_WHITE_TG);
-    uint32 greenTGoods   = config->GetItemCounts(AHB_GREEN_TG);
-    uint32 blueTGoods    = config->GetItemCounts(AHB_BLUE_TG);
-    uint32 purpleTGoods  = config->GetItemCounts(AHB_PURPLE_TG);
-    uint32 orangeTGoods  = config->GetItemCounts(AHB_ORANGE_TG);
-    uint32 yellowTGoods  = config->GetItemCounts(AHB_YELLOW_TG);
-
-    uint32 greyItems     = config->GetItemCounts(AHB_GREY_I);
-    uint32 whiteItems    = config->GetItemCounts(AHB_WHITE_I);
-    uint32 greenItems    = config->GetItemCounts(AHB_GREEN_I);
-    uint32 blueItems     = config->GetItemCounts(AHB_BLUE_I);
-    uint32 purpleItems   = config->GetItemCounts(AHB_PURPLE_I);
-    uint32 orangeItems   = config->GetItemCounts(AHB_ORANGE_I);
-    uint32 yellowItems   = config->GetItemCounts(AHB_YELLOW_I);
+    uint32 maximum[AHB_CATEGORIES];
+    uint32 counts [AHB_CATEGORIES];
+    uint32 deficit[AHB_CATEGORIES];
+
+    for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+    {
+        maximum[category] = config->GetMaximum(category);
+        counts [category] = config->GetItemCounts(category);
+        deficit[category] = 0;
+
+        if (config->Catalog->GetCount(category) > 0 && counts[category] < maximum[category])
+        {
+            deficit[category] = maximum[category] - counts[category];
+        }
+    }
+
+    AHBCategorySampler sampler;
+    sampler.SetWeights(deficit);
 
     //
     // Loop variables
@@ -654,156 +642,67 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
     uint32 tooMany   = 0; // Tracing counter
     uint32 loopBrk   = 0; // Tracing counter
     uint32 err       = 0; // Tracing counter
+    uint32 done      = 0; // Items of the cycle handled in this update
+    bool   outOfTime = false;
 
-    for (uint32 cnt = 1; cnt <= items; cnt++)
-    {
-        uint32 choice      = 0;
-        uint32 itemID      = 0;
-        uint32 loopbreaker = 0;
+    //
+    // The auctions are saved in groups of ListingsPerTransaction, or all together at the end of the update
+    //
 
-        //
-        // Select, in rarity order, a new random item
-        //
+    CharacterDatabaseTransaction trans    = nullptr;
+    uint32                       listings = 0;
 
-        while (itemID == 0 && loopbreaker <= AUCTION_HOUSE_BOT_LOOP_BREAKER)
+    for (uint32 cnt = 1; cnt <= items; cnt++)
+    {
+        if (config->SellBudgetMicroseconds > 0 && cnt > 1 && std::chrono::steady_clock::now() >= deadline)
         {
-            loopbreaker++;
-
-            // Poor
-
-            if ((config->GreyItemsBin.size() > 0) && (greyItems < greyIcount))
-            {
-                choice = 0;
-                itemID = getElement(config->GreyItemsBin, urand(0, config->GreyItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->GreyTradeGoodsBin.size() > 0) && (greyTGoods < greyTGcount))
-            {
-                choice = 7;
-                itemID = getElement(config->GreyTradeGoodsBin, urand(0, config->GreyTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Normal
-
-            if (itemID == 0 && (config->WhiteItemsBin.size() > 0) && (whiteItems < whiteIcount))
-            {
-                choice = 1;
-                itemID = getElement(config->WhiteItemsBin, urand(0, config->WhiteItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->WhiteTradeGoodsBin.size() > 0) && (whiteTGoods < whiteTGcount))
-            {
-                choice = 8;
-                itemID = getElement(config->WhiteTradeGoodsBin, urand(0, config->WhiteTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Uncommon
-
-            if (itemID == 0 && (config->GreenItemsBin.size() > 0) && (greenItems < greenIcount))
-            {
-                choice = 2;
-                itemID = getElement(config->GreenItemsBin, urand(0, config->GreenItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->GreenTradeGoodsBin.size() > 0) && (greenTGoods < greenTGcount))
-            {
-                choice = 9;
-                itemID = getElement(config->GreenTradeGoodsBin, urand(0, config->GreenTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Rare
-
-            if (itemID == 0 && (config->BlueItemsBin.size() > 0) && (blueItems < blueIcount))
-            {
-                choice = 3;
-                itemID = getElement(config->BlueItemsBin, urand(0, config->BlueItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            if (itemID == 0 && (config->BlueTradeGoodsBin.size() > 0) && (blueTGoods < blueTGcount))
-            {
-                choice = 10;
-                itemID = getElement(config->BlueTradeGoodsBin, urand(0, config->BlueTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
-
-            // Epic
+            outOfTime = true;
+            break;
+        }
 
-            if (itemID == 0 && (config->PurpleItemsBin.size() > 0) && (purpleItems < purpleIcount))
-            {
-                choice = 4;
-                itemID = getElement(config->PurpleItemsBin, urand(0, config->PurpleItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        done++;
 
-            if (itemID == 0 && (config->PurpleTradeGoodsBin.size() > 0) && (purpleTGoods < purpleTGcount))
-            {
-                choice = 11;
-                itemID = getElement(config->PurpleTradeGoodsBin, urand(0, config->PurpleTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        uint32         category    = AHB_CATEGORIES;
+        uint32         row         = AHB_CATALOG_NO_ROW;
+        uint32         loopbreaker = 0;
+        AHBListingPlan plan;
 
-            // Legendary
+        //
+        // Select a category that still needs items, then a listing planned for it
+        //
 
-            if (itemID == 0 && (config->OrangeItemsBin.size() > 0) && (orangeItems < orangeIcount))
-            {
-                choice = 5;
-                itemID = getElement(config->OrangeItemsBin, urand(0, config->OrangeItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        if (sampler.IsEmpty())
+        {
+            binEmpty++;
 
-            if (itemID == 0 && (config->OrangeTradeGoodsBin.size() > 0) && (orangeTGoods < orangeTGcount))
+            if (config->DebugOutSeller)
             {
-                choice = 12;
-                itemID = getElement(config->OrangeTradeGoodsBin, urand(0, config->OrangeTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
+                LOG_ERROR("module", "AHBot [{}]: No item could be selected from the bins", _id);
             }
 
-            // Artifact
-
-            if (itemID == 0 && (config->YellowItemsBin.size() > 0) && (yellowItems < yellowIcount))
-            {
-                choice = 6;
-                itemID = getElement(config->YellowItemsBin, urand(0, config->YellowItemsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+            break;
+        }
 
-            if (itemID == 0 && (config->YellowTradeGoodsBin.size() > 0) && (yellowTGoods < yellowTGcount))
-            {
-                choice = 13;
-                itemID = getElement(config->YellowTradeGoodsBin, urand(0, config->YellowTradeGoodsBin.size() - 1), _id, config->DuplicatesCount, auctionHouse);
-            }
+        while (row == AHB_CATALOG_NO_ROW && loopbreaker <= AUCTION_HOUSE_BOT_LOOP_BREAKER)
+        {
+            loopbreaker++;
 
-            if (itemID == 0)
-            {
-                binEmpty++;
-            
-                if (config->DebugOutSeller)
-                {
-                    LOG_ERROR("module", "AHBot [{}]: No item could be selected from the bins", _id);
-                }
-            
-                break;
-            }
+            category = sampler.Sample();
+            row      = getPlan(config, category, _id, config->DuplicatesCount, plan);
         }
 
-        if (itemID == 0 || loopbreaker > AUCTION_HOUSE_BOT_LOOP_BREAKER)
+        if (row == AHB_CATALOG_NO_ROW)
         {
             loopBrk++;
             continue;
         }
 
+        uint32 itemID  = config->Catalog->GetItemId(row);
+
         // 
-        // Retrieve information about the selected item
+        // Create the selected item
         // 
 
-        ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(itemID);
-
-        if (prototype == NULL)
-        {
-            err++;
-
-            if (config->DebugOutSeller)
-            {
-                LOG_ERROR("module", "AHBot [{}]: could not get prototype of item {}", _id, itemID);
-            }
-
-            continue;
-        }
-
         Item* item = Item::CreateItem(itemID, 1, AHBplayer);
 
         if (item == NULL)
@@ -824,33 +723,18 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
 
         item->AddToUpdateQueueOf(AHBplayer);
 
-        uint32 randomPropertyId = Item::GenerateItemRandomPropertyId(itemID);
-
-        if (randomPropertyId != 0)
+        if (plan.randomPropertyId != 0)
         {
-            item->SetItemRandomProperties(randomPropertyId);
-        }
-
-        if (prototype->Quality > AHB_MAX_QUALITY)
-        {
-            err++;
-
-            if (config->DebugOutSeller)
-            {
-                LOG_ERROR("module", "AHBot [{}]: Quality {} TOO HIGH for item {}", _id, prototype->Quality, itemID);
-            }
-
-            item->RemoveFromUpdateQueueOf(AHBplayer);
-            continue;
+            item->SetItemRandomProperties(plan.randomPropertyId);
         }
 
         // 
-        // Determine the price
+        // Determine the price; the market price is only known here
         // 
 
         uint64 buyoutPrice = 0;
         uint64 bidPrice    = 0;
-        uint32 stackCount  = 1;
+        uint32 stackCount  = plan.stackCount;
 
         if (config->SellAtMarketPrice)
         {
@@ -861,44 +745,23 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
         {
             if (config->SellMethod)
             {
-                buyoutPrice = prototype->BuyPrice;
+                buyoutPrice = config->Catalog->GetBuyPrice(row);
             }
             else
             {
-                buyoutPrice = prototype->SellPrice;
+                buyoutPrice = config->Catalog->GetSellPrice(row);
             }
         }
 
-        buyoutPrice = buyoutPrice * urand(config->GetMinPrice(prototype->Quality), config->GetMaxPrice(prototype->Quality));
+        buyoutPrice = buyoutPrice * plan.priceRatio;
         buyoutPrice = buyoutPrice / 100;
 
-        bidPrice    = buyoutPrice * urand(config->GetMinBidPrice(prototype->Quality), config->GetMaxBidPrice(prototype->Quality));
+        bidPrice    = buyoutPrice * plan.bidRatio;
         bidPrice    = bidPrice / 100;
 
-        // 
-        // Determine the stack size
-        // 
-
-        if (config->GetMaxStack(prototype->Quality) > 1 && item->GetMaxStackCount() > 1)
-        {
-            stackCount = minValue(getStackCount(config, item->GetMaxStackCount()), config->GetMaxStack(prototype->Quality));
-        }
-        else if (config->GetMaxStack(prototype->Quality) == 0 && item->GetMaxStackCount() > 1)
-        {
-            stackCount = getStackCount(config, item->GetMaxStackCount());
-        }
-        else
-        {
-            stackCount = 1;
-        }
-
         item->SetCount(stackCount);
 
-        // 
-        // Determine the auction time
-        // 
-
-        uint32 etime = getElapsedTime(config->ElapsingTimeClass);
+        uint32 etime = plan.duration;
 
         // 
         // Determine the deposit
@@ -907,62 +770,28 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
         uint32 dep   = sAuctionMgr->GetAuctionDeposit(ahEntry, etime, item, stackCount);
 
         // 
-        // Perform the auction
+        // Items with a fixed price range ignore the vendor and market prices
         // 
 
-        if (prototype && prototype->SellPrice && prototype->SellPrice > 0)
+        if (config->Catalog->GetSellPrice(row) > 0)
         {
-            uint32 itemEntry = prototype->ItemId;
-            uint32 minPrice = 0;
-            uint32 maxPrice = 0;
-            bool priceOverridden = false;
-
-            // Helper function to check if item is in a list
-            auto isInList = [](uint32 id, const std::initializer_list<uint32>& list) {
-                return std::find(list.begin(), list.end(), id) != list.end();
-            };
-
-            // Define the item lists
-            const std::initializer_list<uint32> gems = {    36766, 36767, 36919, 36922, 36925, 36928, 36931, 36934, 40111, 40112, 40113, 40114, 40115, 40116, 40117, 40118, 40119, 40120, 40121, 40122, 40123, 40124, 40125, 40126, 40127, 40128, 40129, 40130, 40131, 40132, 40133, 40134, 40135, 40136, 40137, 40138, 40139, 40140, 40141, 40142, 40143, 40144, 40145, 40146, 40147, 40148, 40149, 40150, 40151, 40152, 40153, 40154, 40155, 40156, 40157, 40158, 40159, 40160, 40161, 40162, 40163, 40164, 40165, 40166, 40167, 40168, 40169, 40170, 40171, 40172, 40173, 40174, 40175, 40176, 40177, 40178, 40179, 40180, 40181, 40182, 42142, 42143, 42144, 42145, 42146, 42148, 42149, 42150, 42151, 42152, 42153, 42154, 42155, 42156, 42157, 42158, 44066, 45862, 45879, 45880, 45881, 45882, 45883, 45987, 49110};
-            const std::initializer_list<uint32> CraftedHeadChestLegs245 = {    42987, 47589, 47590, 47591, 47592, 47593, 47594, 47595, 47596, 47597, 47598, 47599, 47600, 47601, 47602, 47603, 47604, 47605, 47606, 50001, 50038};
-            const std::initializer_list<uint32> ilvl200to245 = {	37835, 39194, 39235, 39283, 39310, 39472, 39717, 39733, 39762, 40187, 40206, 40246, 40270, 40282, 40302, 40305, 40338, 40347, 40362, 40426, 40439, 40474, 40553, 40558, 40733, 40734, 40735, 40736, 40737, 40738, 40739, 40740, 40741, 41168, 41257, 41383, 41384, 41386, 41387, 41388, 41391, 41392, 41394, 41609, 41610, 42100, 42101, 42102, 42103, 42111, 42113, 42435, 42508, 42642, 42643, 42644, 42645, 42646, 42647, 42989, 42990, 43458, 43459, 43461, 43469, 43481, 43484, 43495, 43502, 43565, 43566, 43573, 43582, 43583, 43584, 43585, 43586, 43587, 43588, 43590, 43591, 43592, 43593, 43594, 43595, 43611, 43612, 43613, 44308, 44309, 44310, 44311, 44312, 44313, 44504, 44926, 44930, 44931, 44948, 45085, 45107, 45141, 45167, 45237, 45247, 45274, 45291, 45301, 45316, 45322, 45435, 45450, 45468, 45480, 45493, 45504, 45550, 45551, 45552, 45553, 45554, 45555, 45556, 45557, 45558, 45559, 45560, 45561, 45562, 45563, 45564, 45565, 45566, 45567, 45680, 45704, 45709, 45859, 45874, 45927, 45975, 46009, 48663, 52252};
-            const std::initializer_list<uint32> OtherBOEs = {    37835, 42988, 44253, 44254, 44255, 33350, 43573, 46970, 47089, 47105, 47149, 47223, 47257, 47278, 47291, 47297, 47315, 47570, 47571, 47572, 47573, 47574, 47575, 47576, 47577, 47579, 47580, 47581, 47582, 47583, 47584, 47585, 47586, 47587, 47588, 49890, 49891, 49892, 49893, 49894, 49895, 49896, 49897, 49898, 49899, 49900, 49901, 49902, 49903, 49904, 49905, 49906, 49907, 49967, 49994, 50015, 50020, 50069, 50175, 50182, 50444, 50447, 50449, 50450, 50451, 50452, 50453, 50472};
-
-            // Check which category the item belongs to and set price range
-            if (isInList(itemEntry, gems))
-            {
-                minPrice = 1000000;
-                maxPrice = 2000000;
-                priceOverridden = true;
-            }
-            else if (isInList(itemEntry, CraftedHeadChestLegs245))
-            {
-                minPrice = 28000000;
-                maxPrice = 37000000;
-                priceOverridden = true;
-            }
-            else if (isInList(itemEntry, ilvl200to245))
-            {
-                minPrice = 8000000;
-                maxPrice = 12000000;
-                priceOverridden = true;
-            }
-            else if (isInList(itemEntry, OtherBOEs))
-            {
-                minPrice = 12500000;
-                maxPrice = 25000000;
-                priceOverridden = true;
-            }
+            AHBPriceOverride const* priceOverride = config->GetPriceOverride(itemID);
 
-            // If the item was found in any list, override the sell price
-            if (priceOverridden)
+            if (priceOverride)
             {
-                buyoutPrice = minPrice + (rand() % (maxPrice - minPrice + 1));
-                bidPrice = buyoutPrice * (0.7 + ((double)rand() / RAND_MAX) * 0.1);
+                buyoutPrice = urand(priceOverride->minBuyout, priceOverride->maxBuyout);
+                bidPrice    = buyoutPrice * urand(priceOverride->minBidRatio, priceOverride->maxBidRatio) / 100;
             }
         }
-        
-        auto trans = CharacterDatabase.BeginTransaction();
+
+        // 
+        // Perform the auction
+        // 
+
+        if (!trans)
+        {
+            trans = CharacterDatabase.BeginTransaction();
+        }
 
         AuctionEntry* auctionEntry      = new AuctionEntry();
         auctionEntry->Id                = sObjectMgr->GenerateAuctionID();
@@ -984,172 +813,314 @@ void AuctionHouseBot::Sell(Player* AHBplayer, AHBConfig* config)
         auctionHouse->AddAuction(auctionEntry);
         auctionEntry->SaveToDB(trans);
 
-        CharacterDatabase.CommitTransaction(trans);
+        listings++;
+
+        if (config->ListingsPerTransaction > 0 && listings >= config->ListingsPerTransaction)
+        {
+            commitListings(trans, listings);
+        }
 
         // 
         // Increments the number of items presents in the auction
         // 
 
-        switch (choice)
+        counts[category]++;
+
+        if (counts[category] >= maximum[category])
         {
-        case 0:
-            ++greyItems;
-            break;
+            sampler.SetWeight(category, 0);
+        }
+        else
+        {
+            sampler.SetWeight(category, maximum[category] - counts[category]);
+        }
 
-        case 1:
-            ++whiteItems;
-            break;
+        noSold++;
 
-        case 2:
-            ++greenItems;
-            break;
+        if (config->TraceSeller)
+        {
+            LOG_INFO("module", "AHBot [{}]: New stack ah={}, id={}, stack={}, bid={}, buyout={}", _id, config->GetAHID(), itemID, stackCount, auctionEntry->startbid, auctionEntry->buyout);
+        }
+    }
 
-        case 3:
-            ++blueItems;
-            break;
+    commitListings(trans, listings);
+    reportListings(config);
 
-        case 4:
-            ++purpleItems;
-            break;
+    //
+    // Keep what is left of the cycle for the next update, if the time ran out
+    //
 
-        case 5:
-            ++orangeItems;
-            break;
+    progress.pending       = outOfTime ? items - done : 0;
+    progress.refillListed += noSold;
 
-        case 6:
-            ++yellowItems;
-            break;
+    if (binEmpty)
+    {
+        endRefill(config, progress);
+    }
 
-        case 7:
-            ++greyTGoods;
-            break;
+    if (config->TraceSeller)
+    {
+        LOG_INFO("module", "AHBot [{}]: auctionhouse {}, req={}, sold={}, aboveMin={}, aboveMax={}, loopBrk={}, noNeed={}, tooMany={}, binEmpty={}, err={}, pending={}", _id, config->GetAHID(), items, noSold, aboveMin, aboveMax, loopBrk, noNeed, tooMany, binEmpty, err, progress.pending);
+    }
+}
 
-        case 8:
-            ++whiteTGoods;
-            break;
+void AuctionHouseBot::commitListings(CharacterDatabaseTransaction& trans, uint32& listings)
+{
+    if (!trans)
+    {
+        return;
+    }
 
-        case 9:
-            ++greenTGoods;
-            break;
+    _listingCommits++;
+    _listingStatements += trans->GetSize();
+    _listingCount      += listings;
 
-        case 10:
-            ++blueTGoods;
-            break;
+    CharacterDatabase.CommitTransaction(trans);
 
-        case 11:
-            ++purpleTGoods;
-            break;
+    trans    = nullptr;
+    listings = 0;
+}
 
-        case 12:
-            ++orangeTGoods;
-            break;
+void AuctionHouseBot::reportListings(AHBConfig* config)
+{
+    uint64 elapsed = uint64(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _listingStatsStart).count());
 
-        case 13:
-            ++yellowTGoods;
-            break;
+    if (elapsed < AHB_LISTING_STATS_SECONDS)
+    {
+        return;
+    }
 
-        default:
-            break;
+    if (config->TraceSeller && _listingCommits > 0)
+    {
+        LOG_INFO("module", "AHBot [{}]: {} auctions saved with {} commits and {} statements in {} s ({:.2f} commits/s, {:.2f} statements/s)", _id, _listingCount, _listingCommits, _listingStatements, elapsed, double(_listingCommits) / elapsed, double(_listingStatements) / elapsed);
+    }
+
+    _listingCommits    = 0;
+    _listingStatements = 0;
+    _listingCount      = 0;
+    _listingStatsStart = std::chrono::steady_clock::now();
+}
+
+void AuctionHouseBot::PrefetchBuyCandidates(AHBConfig* config, std::shared_ptr<AHBBuyerPrefetch> const& prefetch)
+{
+    if (prefetch->pending || gBotsId.empty())
+    {
+        return;
+    }
+
+    prefetch->pending = true;
+
+    //
+    // Auctions of this house not owned by any bot, whichever bot takes the next turn; the result is handled on
+    // the world thread
+    //
+
+    std::string owners;
+
+    for (uint32 botId : gBotsId)
+    {
+        if (!owners.empty())
+        {
+            owners += ',';
         }
 
-        noSold++;
+        owners += std::to_string(botId);
+    }
 
-        if (config->TraceSeller)
+    std::string query = Acore::StringFormat("SELECT id FROM auctionhouse WHERE houseid = {} AND itemowner NOT IN ({})", config->GetAHID(), owners);
+
+    _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(query).WithCallback([prefetch](QueryResult result)
+    {
+        prefetch->pending = false;
+        prefetch->auctions.clear();
+
+        if (!result)
         {
-            LOG_INFO("module", "AHBot [{}]: New stack ah={}, id={}, stack={}, bid={}, buyout={}", _id, config->GetAHID(), itemID, stackCount, auctionEntry->startbid, auctionEntry->buyout);
+            return;
         }
+
+        prefetch->auctions.reserve(result->GetRowCount());
+
+        do
+        {
+            prefetch->auctions.push_back(result->Fetch()->Get<uint32>());
+        } while (result->NextRow());
+    }));
+}
+
+void AuctionHouseBot::ProcessQueryCallbacks()
+{
+    _queryProcessor.ProcessReadyCallbacks();
+}
+
+bool AuctionHouseBot::hasPendingSell(AHBConfig* config)
+{
+    if (!config)
+    {
+        return false;
     }
 
+    std::map<uint32, AHBSellProgress>::const_iterator itr = _sellProgress.find(config->GetAHID());
+
+    return itr != _sellProgress.end() && itr->second.pending > 0;
+}
+
+void AuctionHouseBot::endRefill(AHBConfig* config, AHBSellProgress& progress)
+{
+    if (!progress.refilling)
+    {
+        return;
+    }
+
+    progress.refilling = false;
+    progress.pending   = 0;
+
     if (config->TraceSeller)
     {
-        LOG_INFO("module", "AHBot [{}]: auctionhouse {}, req={}, sold={}, aboveMin={}, aboveMax={}, loopBrk={}, noNeed={}, tooMany={}, binEmpty={}, err={}", _id, config->GetAHID(), items, noSold, aboveMin, aboveMax, loopBrk, noNeed, tooMany, binEmpty, err);
+        uint64 elapsedMs = uint64(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - progress.refillStart).count());
+
+        LOG_INFO("module", "AHBot [{}]: auctionhouse {} refilled in {} ticks, {} auctions listed in {} ms", _id, config->GetAHID(), progress.refillTicks, progress.refillListed, elapsedMs);
     }
 }
 
 // =============================================================================
-// Perform an update cycle
+// Perform an operation on an auction house, when the scheduler says so
 // =============================================================================
 
-void AuctionHouseBot::Update()
+void AuctionHouseBot::Run(uint32 ahID, AHBOperation operation, std::shared_ptr<AHBBuyerPrefetch> const& prefetch)
 {
-    time_t _newrun = time(NULL);
+    AHBConfig* config = GetConfig(ahID);
 
     //
     // If no configuration is associated, then stop here
     //
 
-    if (!_allianceConfig && !_hordeConfig && !_neutralConfig)
+    if (!config || !IsHouseActive(ahID))
     {
         return;
     }
 
+    if (operation == AHB_OPERATION_BUY && config->GetBidsPerInterval() == 0)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+
     //
-    // Preprare for operation
+    // Preprare for operation; the session and the player are built once and reused by all the following updates
     //
 
-    std::string accountName = "AuctionHouseBot" + std::to_string(_account);
+    if (!_AHBplayer)
+    {
+        std::string accountName = "AuctionHouseBot" + std::to_string(_account);
 
-    WorldSession _session(_account, std::move(accountName), nullptr, SEC_PLAYER, sWorld->getIntConfig(CONFIG_EXPANSION), 0, LOCALE_enUS, 0, false, false, 0);
+        _session   = std::make_unique<WorldSession>(_account, std::move(accountName), nullptr, SEC_PLAYER, sWorld->getIntConfig(CONFIG_EXPANSION), 0, LOCALE_enUS, 0, false, false, 0);
+        _AHBplayer = std::make_unique<Player>(_session.get());
 
-    Player _AHBplayer(&_session);
-    _AHBplayer.Initialize(_id);
+        _AHBplayer->Initialize(_id);
+    }
 
-    ObjectAccessor::AddObject(&_AHBplayer);
+    ObjectAccessor::AddObject(_AHBplayer.get());
+
+    std::chrono::steady_clock::duration setupTime = std::chrono::steady_clock::now() - updateStart;
 
     //
-    // Perform update for the factions markets
+    // Perform the operation on the market
     //
 
-    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+    if (operation == AHB_OPERATION_SELL)
     {
-        //
-        // Alliance
-        //
+        Sell(_AHBplayer.get(), config);
+    }
+    else
+    {
+        Buy(_AHBplayer.get(), config, _session.get(), prefetch);
+    }
 
-        if (_allianceConfig)
-        {
-            Sell(&_AHBplayer, _allianceConfig);
+    ObjectAccessor::RemoveObject(_AHBplayer.get());
 
-            if (((_newrun - _lastrun_a_sec) >= (_allianceConfig->GetBiddingInterval() * MINUTE)) && (_allianceConfig->GetBidsPerInterval() > 0))
-            {
-                Buy(&_AHBplayer, _allianceConfig, &_session);
-                _lastrun_a_sec = _newrun;
-            }
-        }
+    //
+    // Keep track of the cost of the updates
+    //
 
-        //
-        // Horde
-        //
+    uint64 setupUs  = uint64(std::chrono::duration_cast<std::chrono::microseconds>(setupTime).count());
+    uint64 updateUs = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count());
 
-        if (_hordeConfig)
-        {
-            Sell(&_AHBplayer, _hordeConfig);
+    _updateCount++;
+    _updateTime += updateUs;
 
-            if (((_newrun - _lastrun_h_sec) >= (_hordeConfig->GetBiddingInterval() * MINUTE)) && (_hordeConfig->GetBidsPerInterval() > 0))
-            {
-                Buy(&_AHBplayer, _hordeConfig, &_session);
-                _lastrun_h_sec = _newrun;
-            }
-        }
+    if (config->DebugOut)
+    {
+        LOG_INFO("module", "AHBot [{}]: {} on ah {} took {} us, session and player {} us (average {} us over {} updates)", _id, operation == AHB_OPERATION_SELL ? "Sell" : "Buy", ahID, updateUs, setupUs, _updateTime / _updateCount, _updateCount);
+    }
+}
 
+AHBConfig* AuctionHouseBot::GetConfig(uint32 ahID)
+{
+    switch (ahID)
+    {
+    case 2:
+        return _allianceConfig;
+    case 6:
+        return _hordeConfig;
+    default:
+        return _neutralConfig;
     }
+}
 
+bool AuctionHouseBot::IsHouseActive(uint32 ahID)
+{
     //
-    // Neutral
+    // With the two factions sharing their markets only the neutral auction house is operated
     //
 
-    if (_neutralConfig)
+    if (ahID == 2 || ahID == 6)
     {
-        Sell(&_AHBplayer, _neutralConfig);
+        return !sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION);
+    }
 
-        if (((_newrun - _lastrun_n_sec) >= (_neutralConfig->GetBiddingInterval() * MINUTE)) && (_neutralConfig->GetBidsPerInterval() > 0))
-        {
-            Buy(&_AHBplayer, _neutralConfig, &_session);
-            _lastrun_n_sec = _newrun;
-        }
+    return true;
+}
+
+void AuctionHouseBot::ResumeSell()
+{
+    //
+    // Go on with the selling cycles interrupted by the time budget; the player exists since an update started them
+    //
+
+    if (!_AHBplayer)
+    {
+        return;
+    }
+
+    bool alliance = hasPendingSell(_allianceConfig);
+    bool horde    = hasPendingSell(_hordeConfig);
+    bool neutral  = hasPendingSell(_neutralConfig);
+
+    if (!alliance && !horde && !neutral)
+    {
+        return;
+    }
+
+    ObjectAccessor::AddObject(_AHBplayer.get());
+
+    if (alliance)
+    {
+        Sell(_AHBplayer.get(), _allianceConfig);
     }
 
-    ObjectAccessor::RemoveObject(&_AHBplayer);
+    if (horde)
+    {
+        Sell(_AHBplayer.get(), _hordeConfig);
+    }
+
+    if (neutral)
+    {
+        Sell(_AHBplayer.get(), _neutralConfig);
+    }
+
+    ObjectAccessor::RemoveObject(_AHBplayer.get());
 }
 
 // =============================================================================
@@ -1287,6 +1258,8 @@ void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col,
         // Iterate through all the autions and if they belong to the bot, make them expired
         //
 
+        auto trans = CharacterDatabase.BeginTransaction();
+
         while (itr != auctionHouse->GetAuctionsEnd())
         {
             if (itr->second->owner.GetCounter() == _id)
@@ -1294,15 +1267,19 @@ void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col,
                 // Expired NOW.
                 itr->second->expire_time = GameTime::GetGameTime().count();
 
-                uint32 id                = itr->second->Id;
-                uint32 expire_time       = itr->second->expire_time;
+                CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AUCTION_EXPIRATION);
+
+                stmt->SetData(0, uint32(itr->second->expire_time));
+                stmt->SetData(1, itr->second->Id);
 
-                CharacterDatabase.Execute("UPDATE auctionhouse SET time = '{}' WHERE id = '{}'", expire_time, id);
+                trans->Append(stmt);
             }
 
             ++itr;
         }
 
+        CharacterDatabase.CommitTransaction(trans);
+
         break;
     }
     case AHBotCommand::minitems:
@@ -1452,7 +1429,15 @@ void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col,
 
         WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerprice{} = '{}' WHERE auctionhouse = '{}'", color, buyerPrice, ahMapID);
 
-        config->SetBuyerPrice(col, buyerPrice);
+        //
+        // The bots share the configuration, the valuations are rebuilt only by the first one
+        //
+
+        if (config->GetBuyerPrice(col) != buyerPrice)
+        {
+            config->SetBuyerPrice(col, buyerPrice);
+            config->InitializeBuyerValuations();
+        }
 
         break;
     }
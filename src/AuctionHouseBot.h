@@ -20,18 +20,45 @@
 #ifndef AUCTION_HOUSE_BOT_H
 #define AUCTION_HOUSE_BOT_H
 
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "Common.h"
 #include "ObjectGuid.h"
+#include "DatabaseEnvFwd.h"
+#include "AsyncCallbackProcessor.h"
+#include "QueryCallback.h"
 #include "AuctionHouseMgr.h"
 
 #include "AuctionHouseBotCommon.h"
 #include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotPlanner.h"
+#include "AuctionHouseBotScheduler.h"
 
 struct AuctionEntry;
 class  Player;
 class  WorldSession;
 
 #define AUCTION_HOUSE_BOT_LOOP_BREAKER 32
+#define AHB_LISTING_STATS_SECONDS      60
+
+//
+// Progress of the seller on one auction house. A cycle interrupted by the time budget keeps its pending items
+// and goes on at the next world update; a refill lasts from the first cycle below the minimum to the one that
+// finds the house above it again.
+//
+
+struct AHBSellProgress
+{
+    uint32 pending      = 0;
+    bool   refilling    = false;
+    uint32 refillTicks  = 0;
+    uint32 refillListed = 0;
+
+    std::chrono::steady_clock::time_point refillStart;
+};
 
 class AuctionHouseBot
 {
@@ -43,16 +70,48 @@ private:
     AHBConfig* _hordeConfig;
     AHBConfig* _neutralConfig;
 
-    time_t     _lastrun_a_sec;
-    time_t     _lastrun_h_sec;
-    time_t     _lastrun_n_sec;
+    //
+    // Session and player used to operate on the markets, created on the first update and kept until the bot is deleted
+    //
+
+    std::unique_ptr<WorldSession> _session;
+    std::unique_ptr<Player>       _AHBplayer;
+
+    //
+    // Time spent in the updates, in microseconds
+    //
+
+    uint64     _updateCount;
+    uint64     _updateTime;
+
+    //
+    // Seller progress, by auction house id
+    //
+
+    std::map<uint32, AHBSellProgress> _sellProgress;
+
+    //
+    // Queries still running, the buyer candidates from the database
+    //
+
+    QueryCallbackProcessor            _queryProcessor;
+
+    //
+    // Database load of the listings, reported every AHB_LISTING_STATS_SECONDS
+    //
+
+    uint64     _listingCommits;
+    uint64     _listingStatements;
+    uint64     _listingCount;
+
+    std::chrono::steady_clock::time_point _listingStatsStart;
 
     //
     // Main operations
     //
 
     void Sell(Player *AHBplayer, AHBConfig *config);
-    void Buy (Player *AHBplayer, AHBConfig *config, WorldSession *session);
+    void Buy (Player *AHBplayer, AHBConfig *config, WorldSession *session, std::shared_ptr<AHBBuyerPrefetch> const& prefetch);
 
     //
     // Utilities
@@ -61,16 +120,26 @@ private:
     inline uint32 minValue(uint32 a, uint32 b) { return a <= b ? a : b; };
 
     uint32 getNofAuctions(AHBConfig* config, AuctionHouseObject* auctionHouse, ObjectGuid guid);
-    uint32 getStackCount(AHBConfig* config, uint32 max);
-    uint32 getElapsedTime(uint32 timeClass);
-    uint32 getElement(std::set<uint32> set, int index, uint32 botId, uint32 maxDup, AuctionHouseObject* auctionHouse);
+    uint32 getPlan(AHBConfig* config, uint32 category, uint32 botId, uint32 maxDup, AHBListingPlan& plan);
+
+    bool hasPendingSell(AHBConfig* config);
+    void endRefill(AHBConfig* config, AHBSellProgress& progress);
+
+    void commitListings(CharacterDatabaseTransaction& trans, uint32& listings);
+    void reportListings(AHBConfig* config);
 
 public:
     AuctionHouseBot(uint32 account, uint32 id);
     ~AuctionHouseBot();
 
     void Initialize(AHBConfig* allianceConfig, AHBConfig* hordeConfig, AHBConfig* neutralConfig);
-    void Update();
+    void Run(uint32 ahID, AHBOperation operation, std::shared_ptr<AHBBuyerPrefetch> const& prefetch);
+    void ResumeSell();
+    void ProcessQueryCallbacks();
+    void PrefetchBuyCandidates(AHBConfig* config, std::shared_ptr<AHBBuyerPrefetch> const& prefetch);
+
+    AHBConfig* GetConfig(uint32 ahID);
+    bool       IsHouseActive(uint32 ahID);
 
     void Commands(AHBotCommand command, uint32 ahMapID, uint32 col, char* args);
 
@@ -55,6 +55,33 @@ void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrSendAuctionOutbiddedMail(
     bool&,                 /* sendNotification */
     bool&                  /* sendMail */)
 {
+    //
+    // A player outbids a bot: the auction, left out of the buyer draws while the bot led it, may be bid on again
+    //
+
+    bool botOutbid = gBotsId.find(auction->bidder.GetCounter()) != gBotsId.end();
+    bool botBidder = newBidder && gBotsId.find(newBidder->GetGUID().GetCounter()) != gBotsId.end();
+
+    if (botOutbid && !botBidder && gBotsId.find(auction->owner.GetCounter()) == gBotsId.end())
+    {
+        AuctionHouseEntry const* ahEntry = sAuctionMgr->GetAuctionHouseEntryFromHouse(auction->GetHouseId());
+        AHBConfig*               config  = gNeutralConfig;
+
+        if (ahEntry)
+        {
+            if (AuctionHouseId(ahEntry->houseId) == AuctionHouseId::Alliance)
+            {
+                config = gAllianceConfig;
+            }
+            else if (AuctionHouseId(ahEntry->houseId) == AuctionHouseId::Horde)
+            {
+                config = gHordeConfig;
+            }
+        }
+
+        config->AddBuyCandidate(auction);
+    }
+
     if (oldBidder && !newBidder)
     {
         if (gBotsId.size() > 0)
@@ -99,6 +126,19 @@ void AHBot_AuctionHouseScript::OnAuctionAdd(AuctionHouseObject* /*ah*/, AuctionE
         }
     }
 
+    //
+    // Keep track of the items listed by the bots, used to limit the duplicates, and of the ones the buyer may bid on
+    //
+
+    if (gBotsId.find(auction->owner.GetCounter()) != gBotsId.end())
+    {
+        config->IncBotListings(auction->owner.GetCounter(), auction->item_template);
+    }
+    else
+    {
+        config->AddBuyCandidate(auction);
+    }
+
     // 
     // Consider only those auctions handled by the bots
     // 
@@ -162,6 +202,19 @@ void AHBot_AuctionHouseScript::OnAuctionRemove(AuctionHouseObject* /*ah*/, Aucti
         }
     }
 
+    //
+    // Keep track of the items listed by the bots, used to limit the duplicates, and of the ones the buyer may bid on
+    //
+
+    if (gBotsId.find(auction->owner.GetCounter()) != gBotsId.end())
+    {
+        config->DecBotListings(auction->owner.GetCounter(), auction->item_template);
+    }
+    else
+    {
+        config->RemoveBuyCandidate(auction->Id);
+    }
+
     // 
     // Consider only those auctions handled by the bots
     // 
@@ -271,15 +324,3 @@ void AHBot_AuctionHouseScript::OnAuctionExpire(AuctionHouseObject* /*ah*/, Aucti
 
     config->DecItemCounts(prototype->Class, prototype->Quality);
 }
-
-void AHBot_AuctionHouseScript::OnBeforeAuctionHouseMgrUpdate()
-{
-    //
-    // For every registered bot, perform an update
-    //
-
-    for (AuctionHouseBot* bot: gBots)
-    {
-        bot->Update();
-    }
-}
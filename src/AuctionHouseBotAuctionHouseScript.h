@@ -25,8 +25,6 @@ public:
     void OnAuctionRemove    (AuctionHouseObject* ah, AuctionEntry* auction) override;
     void OnAuctionSuccessful(AuctionHouseObject* ah, AuctionEntry* auction) override;
     void OnAuctionExpire    (AuctionHouseObject* ah, AuctionEntry* auction) override;
-
-    void OnBeforeAuctionHouseMgrUpdate() override;
 };
 
 #endif /* AUCTION_HOUSE_BOT_AUCTION_HOUSE_SCRIPT_H */
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "Random.h"
+
+#include "AuctionHouseBotCandidates.h"
+
+AHBCandidateSet::AHBCandidateSet()
+{
+
+}
+
+AHBCandidateSet::~AHBCandidateSet()
+{
+
+}
+
+void AHBCandidateSet::Add(uint32 id)
+{
+    if (positions.find(id) != positions.end())
+    {
+        return;
+    }
+
+    positions[id] = uint32(ids.size());
+    ids.push_back(id);
+}
+
+void AHBCandidateSet::Remove(uint32 id)
+{
+    std::unordered_map<uint32, uint32>::iterator it = positions.find(id);
+
+    if (it == positions.end())
+    {
+        return;
+    }
+
+    //
+    // Move the last id into the hole, then drop the last slot
+    //
+
+    uint32 position = it->second;
+
+    positions.erase(it);
+
+    if (position != ids.size() - 1)
+    {
+        ids[position]            = ids.back();
+        positions[ids[position]] = position;
+    }
+
+    ids.pop_back();
+}
+
+void AHBCandidateSet::Clear()
+{
+    ids.clear();
+    positions.clear();
+}
+
+void AHBCandidateSet::Swap(uint32 a, uint32 b)
+{
+    if (a == b)
+    {
+        return;
+    }
+
+    std::swap(ids[a], ids[b]);
+
+    positions[ids[a]] = a;
+    positions[ids[b]] = b;
+}
+
+void AHBCandidateSet::Draw(uint32 count, std::vector<uint32>& drawn)
+{
+    //
+    // Partial Fisher-Yates: slot i receives a random id among the ones not drawn yet
+    //
+
+    uint32 size = Size();
+
+    if (count > size)
+    {
+        count = size;
+    }
+
+    drawn.clear();
+    drawn.reserve(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Swap(i, urand(i, size - 1));
+
+        drawn.push_back(ids[i]);
+    }
+}
+
+AHBExpiryWheel::AHBExpiryWheel()
+{
+    currentTick = 0;
+    size        = 0;
+}
+
+AHBExpiryWheel::~AHBExpiryWheel()
+{
+
+}
+
+void AHBExpiryWheel::Clear(time_t now)
+{
+    for (uint32 slot = 0; slot < AHB_WHEEL_NEAR_SLOTS; ++slot)
+    {
+        nearSlots[slot].clear();
+    }
+
+    for (uint32 slot = 0; slot < AHB_WHEEL_FAR_SLOTS; ++slot)
+    {
+        farSlots[slot].clear();
+    }
+
+    overflow.clear();
+
+    currentTick = uint64(now) / AHB_WHEEL_TICK;
+    size        = 0;
+}
+
+void AHBExpiryWheel::Add(uint32 auctionId, time_t expireTime)
+{
+    Place({ auctionId, uint64(expireTime) / AHB_WHEEL_TICK });
+
+    size++;
+}
+
+void AHBExpiryWheel::Place(AHBExpiry const& entry)
+{
+    //
+    // The first level takes every block up to the one starting within a block from now, so it never spans
+    // more than two blocks; the second level the following 64 blocks; whatever is farther waits aside.
+    //
+
+    AHBExpiry placed = entry;
+
+    if (placed.tick < currentTick)
+    {
+        placed.tick = currentTick;
+    }
+
+    uint64 nearBlock = (currentTick + AHB_WHEEL_BLOCK) >> AHB_WHEEL_BLOCK_BITS;
+    uint64 block     = placed.tick >> AHB_WHEEL_BLOCK_BITS;
+
+    if (block <= nearBlock)
+    {
+        nearSlots[placed.tick % AHB_WHEEL_NEAR_SLOTS].push_back(placed);
+    }
+    else if (block - nearBlock < AHB_WHEEL_FAR_SLOTS)
+    {
+        farSlots[block % AHB_WHEEL_FAR_SLOTS].push_back(placed);
+    }
+    else
+    {
+        overflow.push_back(placed);
+    }
+}
+
+void AHBExpiryWheel::Cascade()
+{
+    //
+    // A new block is within reach of the first level: spread its entries, and look again at the far ones
+    //
+
+    uint64 nearBlock = (currentTick + AHB_WHEEL_BLOCK) >> AHB_WHEEL_BLOCK_BITS;
+
+    std::vector<AHBExpiry> entries;
+    entries.swap(farSlots[nearBlock % AHB_WHEEL_FAR_SLOTS]);
+
+    for (AHBExpiry const& entry : entries)
+    {
+        Place(entry);
+    }
+
+    if (!overflow.empty())
+    {
+        entries.clear();
+        entries.swap(overflow);
+
+        for (AHBExpiry const& entry : entries)
+        {
+            Place(entry);
+        }
+    }
+}
+
+void AHBExpiryWheel::Advance(uint64 tick)
+{
+    //
+    // The auctions of the minutes left behind have expired
+    //
+
+    if (tick <= currentTick)
+    {
+        return;
+    }
+
+    if (tick - currentTick > AHB_WHEEL_BLOCK * AHB_WHEEL_FAR_SLOTS)
+    {
+        //
+        // Too far to move slot by slot: place everything again from the new position
+        //
+
+        std::vector<AHBExpiry> entries;
+
+        for (uint32 slot = 0; slot < AHB_WHEEL_NEAR_SLOTS; ++slot)
+        {
+            nearSlots[slot].clear();
+        }
+
+        for (uint32 slot = 0; slot < AHB_WHEEL_FAR_SLOTS; ++slot)
+        {
+            entries.insert(entries.end(), farSlots[slot].begin(), farSlots[slot].end());
+            farSlots[slot].clear();
+        }
+
+        entries.insert(entries.end(), overflow.begin(), overflow.end());
+        overflow.clear();
+
+        currentTick = tick;
+        size        = 0;
+
+        for (AHBExpiry const& entry : entries)
+        {
+            if (entry.tick >= currentTick)
+            {
+                Place(entry);
+                size++;
+            }
+        }
+
+        return;
+    }
+
+    while (currentTick < tick)
+    {
+        std::vector<AHBExpiry>& slot = nearSlots[currentTick % AHB_WHEEL_NEAR_SLOTS];
+
+        size -= std::min<uint32>(size, uint32(slot.size()));
+        slot.clear();
+
+        currentTick++;
+
+        if (((currentTick + AHB_WHEEL_BLOCK) & (AHB_WHEEL_BLOCK - 1)) == 0)
+        {
+            Cascade();
+        }
+    }
+}
+
+bool AHBExpiryWheel::Pop(time_t now, time_t limit, uint32& auctionId, time_t& expireTime)
+{
+    Advance(uint64(now) / AHB_WHEEL_TICK);
+
+    //
+    // The slots of the first level are in expiration order; the limit never goes past it
+    //
+
+    uint64 lastTick = uint64(limit) / AHB_WHEEL_TICK;
+
+    if (lastTick >= currentTick + AHB_WHEEL_BLOCK)
+    {
+        lastTick = currentTick + AHB_WHEEL_BLOCK - 1;
+    }
+
+    for (uint64 tick = currentTick; tick <= lastTick; ++tick)
+    {
+        std::vector<AHBExpiry>& slot = nearSlots[tick % AHB_WHEEL_NEAR_SLOTS];
+
+        if (slot.empty())
+        {
+            continue;
+        }
+
+        auctionId  = slot.back().auctionId;
+        expireTime = time_t(slot.back().tick * AHB_WHEEL_TICK);
+
+        slot.pop_back();
+        size--;
+
+        return true;
+    }
+
+    return false;
+}
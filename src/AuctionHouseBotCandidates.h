@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_CANDIDATES_H
+#define AUCTION_HOUSE_BOT_CANDIDATES_H
+
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "Common.h"
+
+// =============================================================================
+// Auctions the buyer may bid on, kept in a contiguous array with the position
+// of every id so that adding and removing one is O(1) (the last one fills the
+// hole). Drawing k auctions is a partial Fisher-Yates shuffle of the first k
+// slots: O(k) and never the same auction twice.
+// =============================================================================
+
+class AHBCandidateSet
+{
+private:
+    std::vector<uint32>                ids;
+    std::unordered_map<uint32, uint32> positions;
+
+    void   Swap(uint32 a, uint32 b);
+
+public:
+    AHBCandidateSet();
+    ~AHBCandidateSet();
+
+    void   Add   (uint32 id);
+    void   Remove(uint32 id);
+    void   Clear ();
+
+    uint32 Size() const { return uint32(ids.size()); }
+    bool   IsEmpty() const { return ids.empty(); }
+    bool   Contains(uint32 id) const { return positions.find(id) != positions.end(); }
+
+    void   Draw(uint32 count, std::vector<uint32>& drawn);
+};
+
+//
+// Auction ranked by how far its price per unit falls below the buyer valuation
+//
+
+struct AHBDeal
+{
+    double discount;
+    uint32 auctionId;
+
+    bool operator<(AHBDeal const& other) const { return discount < other.discount; }
+};
+
+// =============================================================================
+// Auctions by expiration time, in a two levels timing wheel with one minute
+// ticks. The first level has a slot per minute for the next two hours; the
+// second one a slot per 64 minutes, moved into the first level as it comes
+// close. Adding an auction and popping the next one to expire are O(1)
+// amortized; auctions no longer there are dropped when they are reached.
+// =============================================================================
+
+#define AHB_WHEEL_TICK         60
+#define AHB_WHEEL_BLOCK_BITS   6
+#define AHB_WHEEL_BLOCK        (1 << AHB_WHEEL_BLOCK_BITS)
+#define AHB_WHEEL_NEAR_SLOTS   (2 * AHB_WHEEL_BLOCK)
+#define AHB_WHEEL_FAR_SLOTS    64
+
+struct AHBExpiry
+{
+    uint32 auctionId;
+    uint64 tick;
+};
+
+class AHBExpiryWheel
+{
+private:
+    std::vector<AHBExpiry> nearSlots[AHB_WHEEL_NEAR_SLOTS];
+    std::vector<AHBExpiry> farSlots[AHB_WHEEL_FAR_SLOTS];
+    std::vector<AHBExpiry> overflow;
+
+    uint64 currentTick;
+    uint32 size;
+
+    void   Place  (AHBExpiry const& entry);
+    void   Advance(uint64 tick);
+    void   Cascade();
+
+public:
+    AHBExpiryWheel();
+    ~AHBExpiryWheel();
+
+    void   Add  (uint32 auctionId, time_t expireTime);
+    void   Clear(time_t now);
+
+    uint32 Size() const { return size; }
+
+    bool   Pop(time_t now, time_t limit, uint32& auctionId, time_t& expireTime);
+};
+
+#endif // AUCTION_HOUSE_BOT_CANDIDATES_H
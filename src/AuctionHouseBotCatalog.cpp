@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "Random.h"
+
+#include "AuctionHouseBotCatalog.h"
+
+AHBCatalog::AHBCatalog()
+{
+
+}
+
+AHBCatalog::~AHBCatalog()
+{
+
+}
+
+void AHBCatalog::Add(uint32 category, ItemTemplate const* prototype)
+{
+    if (category >= AHB_CATEGORIES)
+    {
+        return;
+    }
+
+    bins[category].push_back(uint32(itemId.size()));
+
+    itemId.push_back(prototype->ItemId);
+    buyPrice.push_back(uint32(prototype->BuyPrice));
+    sellPrice.push_back(prototype->SellPrice);
+    maxStack.push_back(prototype->GetMaxStackSize());
+    quality.push_back(uint8(prototype->Quality));
+    itemClass.push_back(uint8(prototype->Class));
+    randomProperty.push_back(prototype->RandomProperty != 0 || prototype->RandomSuffix != 0);
+}
+
+uint32 AHBCatalog::GetCount(uint32 category) const
+{
+    if (category >= AHB_CATEGORIES)
+    {
+        return 0;
+    }
+
+    return uint32(bins[category].size());
+}
+
+uint32 AHBCatalog::GetRandomRow(uint32 category) const
+{
+    uint32 count = GetCount(category);
+
+    if (count == 0)
+    {
+        return AHB_CATALOG_NO_ROW;
+    }
+
+    return bins[category][urand(0, count - 1)];
+}
+
+uint32 AHBCatalog::GetCategory(ItemTemplate const* prototype)
+{
+    //
+    // Trade goods occupy the first block of categories, all the other items the second one.
+    // Qualities above AHB_MAX_QUALITY are not handled and fall outside the valid categories.
+    //
+
+    if (prototype->Quality > AHB_MAX_QUALITY)
+    {
+        return AHB_CATEGORIES;
+    }
+
+    if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+    {
+        return AHB_GREY_TG + prototype->Quality;
+    }
+
+    return AHB_GREY_I + prototype->Quality;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_CATALOG_H
+#define AUCTION_HOUSE_BOT_CATALOG_H
+
+#include <vector>
+
+#include "Common.h"
+#include "ItemTemplate.h"
+
+#include "AuctionHouseBotCommon.h"
+
+#define AHB_CATALOG_NO_ROW    0xFFFFFFFF
+
+// =============================================================================
+// Items that can be sold by the bots, organized by category (see AHB_*_TG and
+// AHB_*_I). Every category is a contiguous array of rows so that a random pick
+// is O(1); each row is the selling profile of one item, stored column by column
+// so that the seller never has to go back to the item templates.
+// =============================================================================
+
+class AHBCatalog
+{
+private:
+    std::vector<uint32> bins[AHB_CATEGORIES];
+
+    //
+    // Selling profiles
+    //
+
+    std::vector<uint32> itemId;
+    std::vector<uint32> buyPrice;
+    std::vector<uint32> sellPrice;
+    std::vector<uint32> maxStack;
+    std::vector<uint8>  quality;
+    std::vector<uint8>  itemClass;
+    std::vector<bool>   randomProperty;
+
+public:
+    AHBCatalog();
+    ~AHBCatalog();
+
+    void   Add(uint32 category, ItemTemplate const* prototype);
+
+    uint32 GetCount(uint32 category) const;
+    uint32 GetRandomRow(uint32 category) const;
+
+    std::vector<uint32> const& GetRows(uint32 category) const { return bins[category]; }
+
+    uint32 GetItemId(uint32 row) const          { return itemId[row];         }
+    uint32 GetBuyPrice(uint32 row) const        { return buyPrice[row];       }
+    uint32 GetSellPrice(uint32 row) const       { return sellPrice[row];      }
+    uint32 GetMaxStack(uint32 row) const        { return maxStack[row];       }
+    uint32 GetQuality(uint32 row) const         { return quality[row];        }
+    uint32 GetClass(uint32 row) const           { return itemClass[row];      }
+    bool   HasRandomProperty(uint32 row) const  { return randomProperty[row]; }
+
+    static uint32 GetCategory(ItemTemplate const* prototype);
+};
+
+#endif // AUCTION_HOUSE_BOT_CATALOG_H
@@ -14,6 +14,12 @@ AHBConfig* gAllianceConfig = new AHBConfig(2);
 AHBConfig* gHordeConfig    = new AHBConfig(6);
 AHBConfig* gNeutralConfig  = new AHBConfig(7);
 
+//
+// Configuration waiting to be swapped in at the next world update
+//
+
+std::atomic<AHBConfigSet*> gPendingConfigs(nullptr);
+
 // 
 // Active bots
 // 
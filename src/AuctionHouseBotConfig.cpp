@@ -17,6 +17,12 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <vector>
+
 #include "AuctionHouseMgr.h"
 #include "Common.h"
 #include "Config.h"
@@ -26,6 +32,7 @@
 #include "Log.h"
 #include "ObjectMgr.h"
 #include "QueryResult.h"
+#include "Timer.h"
 #include "WorldSession.h"
 
 #include "AuctionHouseBotCommon.h"
@@ -33,6 +40,33 @@
 
 using namespace std;
 
+//
+// Columns of mod_auctionhousebot read into the settings, all of them unsigned integers
+//
+
+static char const* const AHBSettingsColumns[] =
+{
+    "minitems", "maxitems",
+
+    "percentgreytradegoods", "percentwhitetradegoods", "percentgreentradegoods", "percentbluetradegoods",
+    "percentpurpletradegoods", "percentorangetradegoods", "percentyellowtradegoods",
+    "percentgreyitems", "percentwhiteitems", "percentgreenitems", "percentblueitems",
+    "percentpurpleitems", "percentorangeitems", "percentyellowitems",
+
+    "minpricegrey", "maxpricegrey", "minpricewhite", "maxpricewhite", "minpricegreen", "maxpricegreen",
+    "minpriceblue", "maxpriceblue", "minpricepurple", "maxpricepurple", "minpriceorange", "maxpriceorange",
+    "minpriceyellow", "maxpriceyellow",
+
+    "minbidpricegrey", "maxbidpricegrey", "minbidpricewhite", "maxbidpricewhite", "minbidpricegreen", "maxbidpricegreen",
+    "minbidpriceblue", "maxbidpriceblue", "minbidpricepurple", "maxbidpricepurple", "minbidpriceorange", "maxbidpriceorange",
+    "minbidpriceyellow", "maxbidpriceyellow",
+
+    "maxstackgrey", "maxstackwhite", "maxstackgreen", "maxstackblue", "maxstackpurple", "maxstackorange", "maxstackyellow",
+
+    "buyerpricegrey", "buyerpricewhite", "buyerpricegreen", "buyerpriceblue", "buyerpricepurple", "buyerpriceorange",
+    "buyerpriceyellow", "buyerbiddinginterval", "buyerbidsperinterval"
+};
+
 AHBConfig::AHBConfig()
 {
     Reset();
@@ -205,6 +239,14 @@ AHBConfig::AHBConfig(uint32 ahid, AHBConfig* conf)
     SellMethod                     = conf->SellMethod;
     ConsiderOnlyBotAuctions        = conf->ConsiderOnlyBotAuctions;
     ItemsPerCycle                  = conf->ItemsPerCycle;
+    InitializationThreads          = conf->InitializationThreads;
+    SellBudgetMicroseconds         = conf->SellBudgetMicroseconds;
+    SellInterval                   = conf->SellInterval;
+    SellerOwnership                = conf->SellerOwnership;
+    ListingsPerTransaction         = conf->ListingsPerTransaction;
+    BuyerStrategy                  = conf->BuyerStrategy;
+    BuyerExpiringWindow            = conf->BuyerExpiringWindow;
+    BuyerCandidateSource           = conf->BuyerCandidateSource;
     Vendor_Items                   = conf->Vendor_Items;
     Loot_Items                     = conf->Loot_Items;
     Other_Items                    = conf->Other_Items;
@@ -285,94 +327,16 @@ AHBConfig::AHBConfig(uint32 ahid, AHBConfig* conf)
         SellerWhiteList.insert(id);
     }
 
-    GreyTradeGoodsBin.clear();
-    for (uint32 id: conf->GreyTradeGoodsBin)
-    {
-        GreyTradeGoodsBin.insert(id);
-    }
-
-    WhiteTradeGoodsBin.clear();
-    for (uint32 id: conf->WhiteTradeGoodsBin)
-    {
-        WhiteTradeGoodsBin.insert(id);
-    }
-
-    GreenTradeGoodsBin.clear();
-    for (uint32 id: conf->GreenTradeGoodsBin)
-    {
-        GreenTradeGoodsBin.insert(id);
-    }
-
-    BlueTradeGoodsBin.clear();
-    for (uint32 id: conf->BlueTradeGoodsBin)
-    {
-        BlueTradeGoodsBin.insert(id);
-    }
-
-    PurpleTradeGoodsBin.clear();
-    for (uint32 id: conf->PurpleTradeGoodsBin)
-    {
-        PurpleTradeGoodsBin.insert(id);
-    }
-
-    OrangeTradeGoodsBin.clear();
-    for (uint32 id: conf->OrangeTradeGoodsBin)
-    {
-        OrangeTradeGoodsBin.insert(id);
-    }
-
-    YellowTradeGoodsBin.clear();
-    for (uint32 id: conf->YellowTradeGoodsBin)
-    {
-        YellowTradeGoodsBin.insert(id);
-    }
-
+    PriceOverrides = conf->PriceOverrides;
 
     //
-    // Bins for items
+    // Bins for trade goods and items
     //
 
-    GreyItemsBin.clear();
-    for (uint32 id: conf->GreyItemsBin)
-    {
-        GreyItemsBin.insert(id);
-    }
-
-    WhiteItemsBin.clear();
-    for (uint32 id: conf->WhiteItemsBin)
-    {
-        WhiteItemsBin.insert(id);
-    }
-
-    GreenItemsBin.clear();
-    for (uint32 id: conf->GreenItemsBin)
-    {
-        GreenItemsBin.insert(id);
-    }
-
-    BlueItemsBin.clear();
-    for (uint32 id: conf->BlueItemsBin)
-    {
-        BlueItemsBin.insert(id);
-    }
-
-    PurpleItemsBin.clear();
-    for (uint32 id: conf->PurpleItemsBin)
-    {
-        PurpleItemsBin.insert(id);
-    }
-
-    OrangeItemsBin.clear();
-    for (uint32 id: conf->OrangeItemsBin)
-    {
-        OrangeItemsBin.insert(id);
-    }
+    Catalog          = conf->Catalog;
+    catalogSignature = conf->catalogSignature;
 
-    YellowItemsBin.clear();
-    for (uint32 id: conf->YellowItemsBin)
-    {
-        YellowItemsBin.insert(id);
-    }
+    buyerValuations  = conf->buyerValuations;
 }
 
 AHBConfig::~AHBConfig()
@@ -513,6 +477,14 @@ void AHBConfig::Reset()
     SellAtMarketPrice              = false;
     ConsiderOnlyBotAuctions        = false;
     ItemsPerCycle                  = 200;
+    InitializationThreads          = 0;
+    SellBudgetMicroseconds         = 0;
+    SellInterval                   = 60;
+    SellerOwnership                = false;
+    ListingsPerTransaction         = 0;
+    BuyerStrategy                  = AHB_BUYER_RANDOM;
+    BuyerExpiringWindow            = 30;
+    BuyerCandidateSource           = AHB_CANDIDATES_MEMORY;
 
     Vendor_Items                   = false;
     Loot_Items                     = true;
@@ -580,25 +552,78 @@ void AHBConfig::Reset()
     DisableItemStore.clear();
     SellerWhiteList.clear();
 
-    GreyTradeGoodsBin.clear();
-    WhiteTradeGoodsBin.clear();
-    GreenTradeGoodsBin.clear();
-    BlueTradeGoodsBin.clear();
-    PurpleTradeGoodsBin.clear();
-    OrangeTradeGoodsBin.clear();
-    YellowTradeGoodsBin.clear();
-
-    GreyItemsBin.clear();
-    WhiteItemsBin.clear();
-    GreenItemsBin.clear();
-    BlueItemsBin.clear();
-    PurpleItemsBin.clear();
-    OrangeItemsBin.clear();
-    YellowItemsBin.clear();
+    PriceOverrides.clear();
+
+    Catalog = std::make_shared<AHBCatalog const>();
+    catalogSignature.clear();
+
+    buyerValuations.clear();
 
     itemsCount.clear();
     itemsSum.clear();
     itemsPrice.clear();
+
+    botListings.clear();
+    botAuctions.clear();
+
+    botAuctionsTotal = 0;
+
+    buyCandidates.Clear();
+    bestDeals = std::priority_queue<AHBDeal>();
+    expiringAuctions.Clear(time(NULL));
+}
+
+std::map<uint32, AHBSettings> AHBConfig::LoadSettings()
+{
+    //
+    // Fetch the settings of all the auction houses with one query, instead of one per column and house
+    //
+
+    uint32 oldMSTime = getMSTime();
+
+    std::map<uint32, AHBSettings> settings;
+    std::string                   columns;
+
+    for (char const* column : AHBSettingsColumns)
+    {
+        columns += ", ";
+        columns += column;
+    }
+
+    QueryResult result = WorldDatabase.Query("SELECT auctionhouse{} FROM mod_auctionhousebot", columns);
+
+    if (!result)
+    {
+        LOG_ERROR("server.loading", ">> Loaded 0 auction house bot settings. DB table `mod_auctionhousebot` is empty.");
+        return settings;
+    }
+
+    do
+    {
+        Field*       fields = result->Fetch();
+        AHBSettings& row    = settings[fields[0].Get<uint32>()];
+
+        for (size_t i = 0; i < std::size(AHBSettingsColumns); ++i)
+        {
+            row[AHBSettingsColumns[i]] = fields[i + 1].Get<uint32>();
+        }
+    } while (result->NextRow());
+
+    LOG_INFO("server.loading", ">> Loaded {} auction house bot settings in {} ms", uint32(settings.size()), GetMSTimeDiffToNow(oldMSTime));
+
+    return settings;
+}
+
+uint32 AHBConfig::GetSetting(AHBSettings const& settings, std::string const& column)
+{
+    AHBSettings::const_iterator itr = settings.find(column);
+
+    if (itr == settings.end())
+    {
+        return 0;
+    }
+
+    return itr->second;
 }
 
 uint32 AHBConfig::GetAHID()
@@ -1551,6 +1576,18 @@ uint32 AHBConfig::GetBuyerPrice(uint32 color)
     }
 }
 
+AHBBuyerValuation const& AHBConfig::GetBuyerValuation(uint32 itemId)
+{
+    static AHBBuyerValuation const unknown;
+
+    if (itemId >= buyerValuations.size())
+    {
+        return unknown;
+    }
+
+    return buyerValuations[itemId];
+}
+
 void AHBConfig::SetBiddingInterval(uint32 value)
 {
     buyerBiddingInterval = value;
@@ -1953,333 +1990,441 @@ uint32 AHBConfig::GetBidsPerInterval()
     return buyerBidsPerInterval;
 }
 
-void AHBConfig::UpdateItemStats(uint32 id, uint32 stackSize, uint64 buyout)
+void AHBConfig::IncBotListings(uint32 botId, uint32 itemId)
 {
-    if (!stackSize)
+    botListings[(uint64(botId) << 32) | itemId]++;
+    botAuctions[botId]++;
+    botAuctionsTotal++;
+}
+
+void AHBConfig::DecBotListings(uint32 botId, uint32 itemId)
+{
+    std::unordered_map<uint64, uint32>::iterator it = botListings.find((uint64(botId) << 32) | itemId);
+
+    if (it == botListings.end())
     {
         return;
     }
 
-    // 
-    // Collects information about the item bought
-    //
-
-    uint32 perUnit = buyout / stackSize;
-
-    if (itemsCount.count(id) == 0)
+    if (it->second <= 1)
     {
-        itemsCount[id] = 1;
-        itemsSum[id]   = perUnit;
-        itemsPrice[id] = perUnit;
+        botListings.erase(it);
     }
     else
     {
-        itemsCount[id]++;
+        it->second--;
+    }
 
-        //
-        // Reset the statistics to force adapt to the market price.
-        // Adds a little of randomness by adding/removing a range of 9 to the threshold.
-        //
+    //
+    // The per bot count exists as long as one of its listings does
+    //
 
-        if (itemsCount[id] > MarketResetThreshold + (urand(1, 19) - 10))
+    std::unordered_map<uint32, uint32>::iterator owner = botAuctions.find(botId);
+
+    if (owner != botAuctions.end())
+    {
+        if (owner->second <= 1)
         {
-            itemsCount[id] = 1;
-            itemsSum[id]   = perUnit;
-            itemsPrice[id] = perUnit;
+            botAuctions.erase(owner);
         }
         else
         {
-            //
-            // Here is decided the price for single unit:
-            // right now is a plain, boring average of the ~100 previous auctions.
-            //
-
-            itemsSum[id]   = (itemsSum[id] + perUnit);
-            itemsPrice[id] = itemsSum[id] / itemsCount[id];
+            owner->second--;
         }
     }
 
-    if (DebugOutConfig)
+    if (botAuctionsTotal > 0)
     {
-        LOG_INFO("module", "Updating market price item={}, price={}", id, itemsPrice[id]);
+        botAuctionsTotal--;
     }
 }
 
-uint64 AHBConfig::GetItemPrice(uint32 id)
+uint32 AHBConfig::GetBotListings(uint32 botId, uint32 itemId)
 {
-    if (itemsCount.count(id) != 0)
+    std::unordered_map<uint64, uint32>::const_iterator it = botListings.find((uint64(botId) << 32) | itemId);
+
+    if (it == botListings.end())
     {
-        return itemsPrice[id];
+        return 0;
     }
 
-    return 0;
+    return it->second;
 }
 
-void AHBConfig::Initialize(std::set<uint32> botsIds)
+uint32 AHBConfig::GetBotAuctions(uint32 botId)
 {
-    InitializeFromFile();
-    InitializeFromSql(botsIds);
-    InitializeBins();
+    std::unordered_map<uint32, uint32>::const_iterator it = botAuctions.find(botId);
+
+    if (it == botAuctions.end())
+    {
+        return 0;
+    }
+
+    return it->second;
 }
 
-void AHBConfig::InitializeFromFile()
+uint32 AHBConfig::GetBotAuctions()
 {
-    //
-    // Load from, the configuration file
-    //
-
-    DebugOut                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG"        , false);
-    DebugOutConfig                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_CONFIG" , false);
-    DebugOutFilters                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_FILTERS", false);
-    DebugOutBuyer                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_BUYER"  , false);
-    DebugOutSeller                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_SELLER" , false);
+    return botAuctionsTotal;
+}
 
-    TraceSeller                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_SELLER" , false);
-    TraceBuyer                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_BUYER"  , false);
+void AHBConfig::ResetBotListings()
+{
+    botListings.clear();
+    botAuctions.clear();
 
-    AHBSeller                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableSeller"           , false);
-    AHBBuyer                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableBuyer"            , false);
-    SellMethod                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForSeller"   , false);
-    BuyMethod                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForBuyer"    , false);
-    SellAtMarketPrice              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseMarketPriceForSeller", false);
-    MarketResetThreshold           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketResetThreshold"   , 25);
-    DuplicatesCount                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DuplicatesCount"        , 0);
-    DivisibleStacks                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DivisibleStacks"        , false);
-    ElapsingTimeClass              = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ElapsingTimeClass"      , 1);
-    ConsiderOnlyBotAuctions        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.ConsiderOnlyBotAuctions", false);
-    ItemsPerCycle                  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle"          , 200);
+    botAuctionsTotal = 0;
+}
 
+void AHBConfig::AddBuyCandidate(AuctionEntry const* auction)
+{
     //
-    // Flags: item types
+    // The buyer reading its candidates from the database needs none of them in memory; an auction is ranked once
     //
 
-    Vendor_Items                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorItems"      , false);
-    Loot_Items                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootItems"        , true);
-    Other_Items                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherItems"       , false);
-    Vendor_TGs                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorTradeGoods" , false);
-    Loot_TGs                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootTradeGoods"   , true);
-    Other_TGs                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherTradeGoods"  , false);
-    Profession_Items               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.ProfessionItems"  , false);
+    if (BuyerCandidateSource == AHB_CANDIDATES_DATABASE || buyCandidates.Contains(auction->Id))
+    {
+        return;
+    }
 
-    //
-    // Flags: items binding
-    //
+    buyCandidates.Add(auction->Id);
 
-    No_Bind                        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.No_Bind"             , true);
-    Bind_When_Picked_Up            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Picked_Up" , false);
-    Bind_When_Equipped             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Equipped"  , true);
-    Bind_When_Use                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Use"       , true);
-    Bind_Quest_Item                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_Quest_Item"     , false);
+    double discount;
 
-    //
-    // Flags: misc
-    //
+    if (BuyerStrategy == AHB_BUYER_BEST_DEAL && GetDiscount(auction, discount))
+    {
+        bestDeals.push({ discount, auction->Id });
+    }
 
-    DisableConjured                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableConjured"               , false);
-    DisableGems                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableGems"                   , false);
-    DisableMoney                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoney"                  , false);
-    DisableMoneyLoot               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoneyLoot"              , false);
-    DisableLootable                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableLootable"               , false);
-    DisableKeys                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableKeys"                   , false);
-    DisableDuration                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDuration"               , false);
-    DisableBOP_Or_Quest_NoReqLevel = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableBOP_Or_Quest_NoReqLevel", false);
+    if (BuyerStrategy == AHB_BUYER_EXPIRING)
+    {
+        expiringAuctions.Add(auction->Id, auction->expire_time);
+    }
+}
 
-    //
-    // Flags: items per class
-    //
+void AHBConfig::RemoveBuyCandidate(uint32 auctionId)
+{
+    if (BuyerCandidateSource == AHB_CANDIDATES_DATABASE)
+    {
+        return;
+    }
 
-    DisableWarriorItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarriorItems"    , false);
-    DisablePaladinItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePaladinItems"    , false);
-    DisableHunterItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableHunterItems"     , false);
-    DisableRogueItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableRogueItems"      , false);
-    DisablePriestItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePriestItems"     , false);
-    DisableDKItems                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDKItems"         , false);
-    DisableShamanItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableShamanItems"     , false);
-    DisableMageItems               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMageItems"       , false);
-    DisableWarlockItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarlockItems"    , false);
-    DisableUnusedClassItems        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableUnusedClassItems", false);
-    DisableDruidItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDruidItems"      , false);
+    buyCandidates.Remove(auctionId);
+}
+
+void AHBConfig::ResetBuyCandidates()
+{
+    buyCandidates.Clear();
+    bestDeals = std::priority_queue<AHBDeal>();
+    expiringAuctions.Clear(time(NULL));
+}
 
+bool AHBConfig::GetDiscount(AuctionEntry const* auction, double& discount)
+{
     //
-    // Items level and skills
+    // Share of the value of the stack the next bid would save; only the auctions below the valuation are deals
     //
 
-    DisableItemsBelowLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowLevel"       , 0);
-    DisableItemsAboveLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveLevel"       , 0);
-    DisableItemsBelowGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowGUID"        , 0);
-    DisableItemsAboveGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveGUID"        , 0);
-    DisableItemsBelowReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqLevel"    , 0);
-    DisableItemsAboveReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqLevel"    , 0);
-    DisableItemsBelowReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqSkillRank", 0);
-    DisableItemsAboveReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqSkillRank", 0);
+    AHBBuyerValuation const& valuation = GetBuyerValuation(auction->item_template);
 
-    //
-    // Trade goods level and skills
-    //
+    if (valuation.excluded || auction->itemCount == 0)
+    {
+        return false;
+    }
 
-    DisableTGsBelowLevel           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowLevel"       , 0);
-    DisableTGsAboveLevel           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveLevel"       , 0);
-    DisableTGsBelowGUID            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowGUID"        , 0);
-    DisableTGsAboveGUID            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveGUID"        , 0);
-    DisableTGsBelowReqLevel        = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqLevel"    , 0);
-    DisableTGsAboveReqLevel        = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqLevel"    , 0);
-    DisableTGsBelowReqSkillRank    = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqSkillRank", 0);
-    DisableTGsAboveReqSkillRank    = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqSkillRank", 0);
+    double value = double(valuation.maxUnitBid) * auction->itemCount;
+    double price = double(auction->bid ? auction->bid : auction->startbid);
 
-    //
-    // Whitelists
-    //
+    if (price >= value)
+    {
+        return false;
+    }
 
-    SellerWhiteList                = getCommaSeparatedIntegers(sConfigMgr->GetOption<std::string>("AuctionHouseBot.SellerWhiteList", ""));
+    discount = 1.0 - price / value;
+
+    return true;
 }
 
-void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
+void AHBConfig::RebuildBestDeals()
 {
+    bestDeals = std::priority_queue<AHBDeal>();
+
+    if (BuyerStrategy != AHB_BUYER_BEST_DEAL || buyCandidates.IsEmpty())
+    {
+        return;
+    }
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+
+    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
+    {
+        double discount;
+
+        if (buyCandidates.Contains(itr->second->Id) && GetDiscount(itr->second, discount))
+        {
+            bestDeals.push({ discount, itr->second->Id });
+        }
+    }
+}
+
+void AHBConfig::DrawBestDeals(uint32 count, uint32 botId, std::vector<uint32>& drawn)
+{
+    drawn.clear();
+
+    //
+    // The auctions that are gone are left in the heap until they reach the top; do not let them pile up
     //
-    // Load min and max items
-    //
 
-    SetMinItems(WorldDatabase.Query("SELECT minitems FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxItems(WorldDatabase.Query("SELECT maxitems FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+    if (bestDeals.size() > 2 * buyCandidates.Size() + 64)
+    {
+        RebuildBestDeals();
+    }
+
+    AuctionHouseObject*  auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+    std::vector<AHBDeal> kept;
+    uint32               examined     = 0;
+
+    while (drawn.size() < count && examined < count * AHB_BUYER_EXAMINED_PER_DRAW && !bestDeals.empty())
+    {
+        AHBDeal deal = bestDeals.top();
+        bestDeals.pop();
+
+        if (!buyCandidates.Contains(deal.auctionId))
+        {
+            continue;
+        }
+
+        AuctionEntry* auction = auctionHouse->GetAuction(deal.auctionId);
+        double        discount;
+
+        if (!auction)
+        {
+            continue;
+        }
+
+        //
+        // The bot already holds the highest bid: out of the draws until a player outbids it
+        //
+
+        if (auction->bidder.GetCounter() == botId)
+        {
+            RemoveBuyCandidate(deal.auctionId);
+            continue;
+        }
+
+        //
+        // Not a deal anymore, but it may become one again if the valuations change; rank it last. Only the auctions
+        // put back like this count against the limit, the others leave the heap for good.
+        //
+
+        if (!GetDiscount(auction, discount))
+        {
+            kept.push_back({ 0.0, deal.auctionId });
+            ++examined;
+            continue;
+        }
+
+        //
+        // Outbid since it was ranked: put it back where it belongs now
+        //
+
+        if (discount < deal.discount)
+        {
+            bestDeals.push({ discount, deal.auctionId });
+            ++examined;
+            continue;
+        }
+
+        drawn.push_back(deal.auctionId);
+        kept.push_back(deal);
+    }
 
     //
-    // Load percentages
+    // The auctions handed out or skipped stay ranked until a bid changes their price
     //
 
-    uint32 greytg   = WorldDatabase.Query("SELECT percentgreytradegoods   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 whitetg  = WorldDatabase.Query("SELECT percentwhitetradegoods  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 greentg  = WorldDatabase.Query("SELECT percentgreentradegoods  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 bluetg   = WorldDatabase.Query("SELECT percentbluetradegoods   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 purpletg = WorldDatabase.Query("SELECT percentpurpletradegoods FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 orangetg = WorldDatabase.Query("SELECT percentorangetradegoods FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 yellowtg = WorldDatabase.Query("SELECT percentyellowtradegoods FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
+    for (AHBDeal const& deal : kept)
+    {
+        bestDeals.push(deal);
+    }
+}
 
-    uint32 greyi    = WorldDatabase.Query("SELECT percentgreyitems        FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 whitei   = WorldDatabase.Query("SELECT percentwhiteitems       FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 greeni   = WorldDatabase.Query("SELECT percentgreenitems       FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 bluei    = WorldDatabase.Query("SELECT percentblueitems        FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 purplei  = WorldDatabase.Query("SELECT percentpurpleitems      FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 orangei  = WorldDatabase.Query("SELECT percentorangeitems      FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
-    uint32 yellowi  = WorldDatabase.Query("SELECT percentyellowitems      FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>();
+void AHBConfig::DrawExpiring(uint32 count, uint32 botId, std::vector<uint32>& drawn)
+{
+    drawn.clear();
 
-    SetPercentages(greytg, whitetg, greentg, bluetg, purpletg, orangetg, yellowtg, greyi, whitei, greeni, bluei, purplei, orangei, yellowi);
+    time_t now   = time(NULL);
+    time_t limit = now + time_t(BuyerExpiringWindow) * MINUTE;
 
-    // 
-    // Load min and max prices
-    // 
+    AuctionHouseObject*                    auctionHouse = sAuctionMgr->GetAuctionsMap(GetAHFID());
+    std::vector<std::pair<uint32, time_t>> kept;
 
-    SetMinPrice(AHB_GREY  , WorldDatabase.Query("SELECT minpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_GREY  , WorldDatabase.Query("SELECT maxpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_WHITE , WorldDatabase.Query("SELECT minpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_WHITE , WorldDatabase.Query("SELECT maxpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_GREEN , WorldDatabase.Query("SELECT minpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_GREEN , WorldDatabase.Query("SELECT maxpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_BLUE  , WorldDatabase.Query("SELECT minpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_BLUE  , WorldDatabase.Query("SELECT maxpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_PURPLE, WorldDatabase.Query("SELECT minpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_PURPLE, WorldDatabase.Query("SELECT maxpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_ORANGE, WorldDatabase.Query("SELECT minpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_ORANGE, WorldDatabase.Query("SELECT maxpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinPrice(AHB_YELLOW, WorldDatabase.Query("SELECT minpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxPrice(AHB_YELLOW, WorldDatabase.Query("SELECT maxpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+    uint32 auctionId;
+    time_t expireTime;
 
-    // 
-    // Load min and max bid prices
-    // 
+    //
+    // Every auction popped is either handed out or leaves the wheel for good, so a draw needs no other limit
+    //
 
-    SetMinBidPrice(AHB_GREY  , WorldDatabase.Query("SELECT minbidpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_GREY  , WorldDatabase.Query("SELECT maxbidpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_WHITE , WorldDatabase.Query("SELECT minbidpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_WHITE , WorldDatabase.Query("SELECT maxbidpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_GREEN , WorldDatabase.Query("SELECT minbidpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_GREEN , WorldDatabase.Query("SELECT maxbidpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_BLUE  , WorldDatabase.Query("SELECT minbidpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_BLUE  , WorldDatabase.Query("SELECT maxbidpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_PURPLE, WorldDatabase.Query("SELECT minbidpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_PURPLE, WorldDatabase.Query("SELECT maxbidpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_ORANGE, WorldDatabase.Query("SELECT minbidpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_ORANGE, WorldDatabase.Query("SELECT maxbidpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMinBidPrice(AHB_YELLOW, WorldDatabase.Query("SELECT minbidpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxBidPrice(AHB_YELLOW, WorldDatabase.Query("SELECT maxbidpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+    while (drawn.size() < count && expiringAuctions.Pop(now, limit, auctionId, expireTime))
+    {
+        AuctionEntry* auction = buyCandidates.Contains(auctionId) ? auctionHouse->GetAuction(auctionId) : nullptr;
+
+        if (!auction)
+        {
+            continue;
+        }
+
+        //
+        // The bot already holds the highest bid: out of the draws until a player outbids it
+        //
+
+        if (auction->bidder.GetCounter() == botId)
+        {
+            RemoveBuyCandidate(auctionId);
+            continue;
+        }
+
+        drawn.push_back(auctionId);
+        kept.push_back({ auctionId, expireTime });
+    }
+
+    //
+    // The auctions handed out can still be outbid until they expire
+    //
+
+    for (std::pair<uint32, time_t> const& expiry : kept)
+    {
+        expiringAuctions.Add(expiry.first, expiry.second);
+    }
+}
+
+void AHBConfig::UpdateItemStats(uint32 id, uint32 stackSize, uint64 buyout)
+{
+    if (!stackSize)
+    {
+        return;
+    }
 
     // 
-    // Load max stacks
-    // 
+    // Collects information about the item bought
+    //
+
+    uint32 perUnit = buyout / stackSize;
+
+    if (itemsCount.count(id) == 0)
+    {
+        itemsCount[id] = 1;
+        itemsSum[id]   = perUnit;
+        itemsPrice[id] = perUnit;
+    }
+    else
+    {
+        itemsCount[id]++;
+
+        //
+        // Reset the statistics to force adapt to the market price.
+        // Adds a little of randomness by adding/removing a range of 9 to the threshold.
+        //
+
+        if (itemsCount[id] > MarketResetThreshold + (urand(1, 19) - 10))
+        {
+            itemsCount[id] = 1;
+            itemsSum[id]   = perUnit;
+            itemsPrice[id] = perUnit;
+        }
+        else
+        {
+            //
+            // Here is decided the price for single unit:
+            // right now is a plain, boring average of the ~100 previous auctions.
+            //
 
-    SetMaxStack(AHB_GREY  , WorldDatabase.Query("SELECT maxstackgrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_WHITE , WorldDatabase.Query("SELECT maxstackwhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_GREEN , WorldDatabase.Query("SELECT maxstackgreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_BLUE  , WorldDatabase.Query("SELECT maxstackblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_PURPLE, WorldDatabase.Query("SELECT maxstackpurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_ORANGE, WorldDatabase.Query("SELECT maxstackorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetMaxStack(AHB_YELLOW, WorldDatabase.Query("SELECT maxstackyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+            itemsSum[id]   = (itemsSum[id] + perUnit);
+            itemsPrice[id] = itemsSum[id] / itemsCount[id];
+        }
+    }
 
     if (DebugOutConfig)
     {
-        LOG_INFO("module", "Settings for Auctionhouse {}", GetAHID());
+        LOG_INFO("module", "Updating market price item={}, price={}", id, itemsPrice[id]);
+    }
+}
 
-        LOG_INFO("module", "minItems                = {}", GetMinItems());
-        LOG_INFO("module", "maxItems                = {}", GetMaxItems());
+uint64 AHBConfig::GetItemPrice(uint32 id)
+{
+    if (itemsCount.count(id) != 0)
+    {
+        return itemsPrice[id];
+    }
 
-        LOG_INFO("module", "percentGreyTradeGoods   = {}", GetPercentages(AHB_GREY_TG));
-        LOG_INFO("module", "percentWhiteTradeGoods  = {}", GetPercentages(AHB_WHITE_TG));
-        LOG_INFO("module", "percentGreenTradeGoods  = {}", GetPercentages(AHB_GREEN_TG));
-        LOG_INFO("module", "percentBlueTradeGoods   = {}", GetPercentages(AHB_BLUE_TG));
-        LOG_INFO("module", "percentPurpleTradeGoods = {}", GetPercentages(AHB_PURPLE_TG));
-        LOG_INFO("module", "percentOrangeTradeGoods = {}", GetPercentages(AHB_ORANGE_TG));
-        LOG_INFO("module", "percentYellowTradeGoods = {}", GetPercentages(AHB_YELLOW_TG));
-        LOG_INFO("module", "percentGreyItems        = {}", GetPercentages(AHB_GREY_I));
-        LOG_INFO("module", "percentWhiteItems       = {}", GetPercentages(AHB_WHITE_I));
-        LOG_INFO("module", "percentGreenItems       = {}", GetPercentages(AHB_GREEN_I));
-        LOG_INFO("module", "percentBlueItems        = {}", GetPercentages(AHB_BLUE_I));
-        LOG_INFO("module", "percentPurpleItems      = {}", GetPercentages(AHB_PURPLE_I));
-        LOG_INFO("module", "percentOrangeItems      = {}", GetPercentages(AHB_ORANGE_I));
-        LOG_INFO("module", "percentYellowItems      = {}", GetPercentages(AHB_YELLOW_I));
+    return 0;
+}
 
-        LOG_INFO("module", "minPriceGrey            = {}", GetMinPrice(AHB_GREY));
-        LOG_INFO("module", "maxPriceGrey            = {}", GetMaxPrice(AHB_GREY));
-        LOG_INFO("module", "minPriceWhite           = {}", GetMinPrice(AHB_WHITE));
-        LOG_INFO("module", "maxPriceWhite           = {}", GetMaxPrice(AHB_WHITE));
-        LOG_INFO("module", "minPriceGreen           = {}", GetMinPrice(AHB_GREEN));
-        LOG_INFO("module", "maxPriceGreen           = {}", GetMaxPrice(AHB_GREEN));
-        LOG_INFO("module", "minPriceBlue            = {}", GetMinPrice(AHB_BLUE));
-        LOG_INFO("module", "maxPriceBlue            = {}", GetMaxPrice(AHB_BLUE));
-        LOG_INFO("module", "minPricePurple          = {}", GetMinPrice(AHB_PURPLE));
-        LOG_INFO("module", "maxPricePurple          = {}", GetMaxPrice(AHB_PURPLE));
-        LOG_INFO("module", "minPriceOrange          = {}", GetMinPrice(AHB_ORANGE));
-        LOG_INFO("module", "maxPriceOrange          = {}", GetMaxPrice(AHB_ORANGE));
-        LOG_INFO("module", "minPriceYellow          = {}", GetMinPrice(AHB_YELLOW));
-        LOG_INFO("module", "maxPriceYellow          = {}", GetMaxPrice(AHB_YELLOW));
+void AHBConfig::TakeItemStats(AHBConfig* other)
+{
+    //
+    // The market prices are learned while the server runs, they are not part of the configuration
+    //
 
-        LOG_INFO("module", "minBidPriceGrey         = {}", GetMinBidPrice(AHB_GREY));
-        LOG_INFO("module", "maxBidPriceGrey         = {}", GetMaxBidPrice(AHB_GREY));
-        LOG_INFO("module", "minBidPriceWhite        = {}", GetMinBidPrice(AHB_WHITE));
-        LOG_INFO("module", "maxBidPriceWhite        = {}", GetMaxBidPrice(AHB_WHITE));
-        LOG_INFO("module", "minBidPriceGreen        = {}", GetMinBidPrice(AHB_GREEN));
-        LOG_INFO("module", "maxBidPriceGreen        = {}", GetMaxBidPrice(AHB_GREEN));
-        LOG_INFO("module", "minBidPriceBlue         = {}", GetMinBidPrice(AHB_BLUE));
-        LOG_INFO("module", "maxBidPriceBlue         = {}", GetMinBidPrice(AHB_BLUE));
-        LOG_INFO("module", "minBidPricePurple       = {}", GetMinBidPrice(AHB_PURPLE));
-        LOG_INFO("module", "maxBidPricePurple       = {}", GetMaxBidPrice(AHB_PURPLE));
-        LOG_INFO("module", "minBidPriceOrange       = {}", GetMinBidPrice(AHB_ORANGE));
-        LOG_INFO("module", "maxBidPriceOrange       = {}", GetMaxBidPrice(AHB_ORANGE));
-        LOG_INFO("module", "minBidPriceYellow       = {}", GetMinBidPrice(AHB_YELLOW));
-        LOG_INFO("module", "maxBidPriceYellow       = {}", GetMaxBidPrice(AHB_YELLOW));
+    itemsCount.swap(other->itemsCount);
+    itemsSum.swap  (other->itemsSum);
+    itemsPrice.swap(other->itemsPrice);
+}
 
-        LOG_INFO("module", "maxStackGrey            = {}", GetMaxStack(AHB_GREY));
-        LOG_INFO("module", "maxStackWhite           = {}", GetMaxStack(AHB_WHITE));
-        LOG_INFO("module", "maxStackGreen           = {}", GetMaxStack(AHB_GREEN));
-        LOG_INFO("module", "maxStackBlue            = {}", GetMaxStack(AHB_BLUE));
-        LOG_INFO("module", "maxStackPurple          = {}", GetMaxStack(AHB_PURPLE));
-        LOG_INFO("module", "maxStackOrange          = {}", GetMaxStack(AHB_ORANGE));
-        LOG_INFO("module", "maxStackYellow          = {}", GetMaxStack(AHB_YELLOW));
+AHBPriceOverride const* AHBConfig::GetPriceOverride(uint32 itemId) const
+{
+    //
+    // The last range starting at or before the item is the only one that may contain it
+    //
+
+    std::vector<AHBPriceOverride>::const_iterator it = std::upper_bound(PriceOverrides.begin(), PriceOverrides.end(), itemId, [](uint32 id, AHBPriceOverride const& priceOverride)
+    {
+        return id < priceOverride.itemStart;
+    });
+
+    if (it == PriceOverrides.begin())
+    {
+        return nullptr;
+    }
+
+    --it;
+
+    if (itemId > it->itemEnd)
+    {
+        return nullptr;
     }
 
+    return &(*it);
+}
+
+void AHBConfig::Initialize(std::set<uint32> botsIds, AHBSettings const& settings, AHBConfig const* shared)
+{
+    InitializeSettings(settings, shared);
+    InitializeAuctions(botsIds);
+}
+
+void AHBConfig::InitializeSettings(AHBSettings const& settings, AHBConfig const* shared)
+{
+    //
+    // Nothing here touches the auction house, so it can run away from the world thread
+    //
+
+    InitializeFromFile();
+    InitializeFromSql(settings);
+    InitializeBins(shared);
+    InitializeBuyerValuations();
+}
+
+void AHBConfig::InitializeAuctions(std::set<uint32> botsIds)
+{
     //
     // Reset the situation of the auction house
     //
 
     ResetItemCounts();
+    ResetBotListings();
+    ResetBuyCandidates();
 
     //
     // Update the situation of the auction house
@@ -2295,6 +2440,19 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
             AuctionEntry* Aentry = itr->second;
             Item*         item   = sAuctionMgr->GetAItem(Aentry->item_guid);
 
+            //
+            // Keep track of the items listed by the bots, used to limit the duplicates, and of the ones the buyer may bid on
+            //
+
+            if (botsIds.find(Aentry->owner.GetCounter()) != botsIds.end())
+            {
+                IncBotListings(Aentry->owner.GetCounter(), Aentry->item_template);
+            }
+            else if (botsIds.find(Aentry->bidder.GetCounter()) == botsIds.end())
+            {
+                AddBuyCandidate(Aentry);
+            }
+
             //
             // If it has to only consider the bots auctions, skip the ones belonging to the players
             //
@@ -2421,32 +2579,308 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
         LOG_INFO("module", "    Orange Items       {}", GetItemCounts(AHB_ORANGE_I));
         LOG_INFO("module", "    Yellow Items       {}", GetItemCounts(AHB_YELLOW_I));
     }
+}
 
+void AHBConfig::InitializeFromFile()
+{
     //
-    // Auctions buyer
-    //
-
-    SetBuyerPrice(AHB_GREY  , WorldDatabase.Query("SELECT buyerpricegrey   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_WHITE , WorldDatabase.Query("SELECT buyerpricewhite  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_GREEN , WorldDatabase.Query("SELECT buyerpricegreen  FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_BLUE  , WorldDatabase.Query("SELECT buyerpriceblue   FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_PURPLE, WorldDatabase.Query("SELECT buyerpricepurple FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_ORANGE, WorldDatabase.Query("SELECT buyerpriceorange FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-    SetBuyerPrice(AHB_YELLOW, WorldDatabase.Query("SELECT buyerpriceyellow FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-
-    //
-    // Load bidding interval
+    // Load from, the configuration file
     //
 
-    SetBiddingInterval(WorldDatabase.Query("SELECT buyerbiddinginterval FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
-
-    //
-    // Load bids per interval
-    //
+    DebugOut                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG"        , false);
+    DebugOutConfig                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_CONFIG" , false);
+    DebugOutFilters                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_FILTERS", false);
+    DebugOutBuyer                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_BUYER"  , false);
+    DebugOutSeller                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DEBUG_SELLER" , false);
 
-    SetBidsPerInterval(WorldDatabase.Query("SELECT buyerbidsperinterval FROM mod_auctionhousebot WHERE auctionhouse = {}", GetAHID())->Fetch()->Get<uint32>());
+    TraceSeller                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_SELLER" , false);
+    TraceBuyer                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.TRACE_BUYER"  , false);
 
-    if (DebugOutConfig)
+    AHBSeller                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableSeller"           , false);
+    AHBBuyer                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.EnableBuyer"            , false);
+    SellMethod                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForSeller"   , false);
+    BuyMethod                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseBuyPriceForBuyer"    , false);
+    SellAtMarketPrice              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.UseMarketPriceForSeller", false);
+    MarketResetThreshold           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketResetThreshold"   , 25);
+    DuplicatesCount                = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DuplicatesCount"        , 0);
+    DivisibleStacks                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DivisibleStacks"        , false);
+    ElapsingTimeClass              = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ElapsingTimeClass"      , 1);
+    ConsiderOnlyBotAuctions        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.ConsiderOnlyBotAuctions", false);
+    ItemsPerCycle                  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle"          , 200);
+    InitializationThreads          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.InitializationThreads"  , 0);
+    SellBudgetMicroseconds         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.SellBudgetMicroseconds" , 0);
+    SellInterval                   = sConfigMgr->GetOption<uint32>("AuctionHouseBot.SellInterval"           , 60);
+    SellerOwnership                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.SellerOwnership"        , false);
+    ListingsPerTransaction         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ListingsPerTransaction" , 0);
+    BuyerStrategy                  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.BuyerStrategy"          , AHB_BUYER_RANDOM);
+    BuyerExpiringWindow            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.BuyerExpiringWindow"    , 30);
+    BuyerCandidateSource           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.BuyerCandidateSource"   , AHB_CANDIDATES_MEMORY);
+
+    //
+    // The expiring auctions are looked for in the first level of the timing wheel only
+    //
+
+    if (BuyerExpiringWindow > AHB_WHEEL_BLOCK)
+    {
+        BuyerExpiringWindow = AHB_WHEEL_BLOCK;
+    }
+
+    //
+    // Flags: item types
+    //
+
+    Vendor_Items                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorItems"      , false);
+    Loot_Items                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootItems"        , true);
+    Other_Items                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherItems"       , false);
+    Vendor_TGs                     = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.VendorTradeGoods" , false);
+    Loot_TGs                       = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.LootTradeGoods"   , true);
+    Other_TGs                      = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.OtherTradeGoods"  , false);
+    Profession_Items               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.ProfessionItems"  , false);
+
+    //
+    // Flags: items binding
+    //
+
+    No_Bind                        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.No_Bind"             , true);
+    Bind_When_Picked_Up            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Picked_Up" , false);
+    Bind_When_Equipped             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Equipped"  , true);
+    Bind_When_Use                  = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_When_Use"       , true);
+    Bind_Quest_Item                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.Bind_Quest_Item"     , false);
+
+    //
+    // Flags: misc
+    //
+
+    DisableConjured                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableConjured"               , false);
+    DisableGems                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableGems"                   , false);
+    DisableMoney                   = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoney"                  , false);
+    DisableMoneyLoot               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMoneyLoot"              , false);
+    DisableLootable                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableLootable"               , false);
+    DisableKeys                    = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableKeys"                   , false);
+    DisableDuration                = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDuration"               , false);
+    DisableBOP_Or_Quest_NoReqLevel = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableBOP_Or_Quest_NoReqLevel", false);
+
+    //
+    // Flags: items per class
+    //
+
+    DisableWarriorItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarriorItems"    , false);
+    DisablePaladinItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePaladinItems"    , false);
+    DisableHunterItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableHunterItems"     , false);
+    DisableRogueItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableRogueItems"      , false);
+    DisablePriestItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisablePriestItems"     , false);
+    DisableDKItems                 = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDKItems"         , false);
+    DisableShamanItems             = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableShamanItems"     , false);
+    DisableMageItems               = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableMageItems"       , false);
+    DisableWarlockItems            = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableWarlockItems"    , false);
+    DisableUnusedClassItems        = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableUnusedClassItems", false);
+    DisableDruidItems              = sConfigMgr->GetOption<bool>  ("AuctionHouseBot.DisableDruidItems"      , false);
+
+    //
+    // Items level and skills
+    //
+
+    DisableItemsBelowLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowLevel"       , 0);
+    DisableItemsAboveLevel         = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveLevel"       , 0);
+    DisableItemsBelowGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowGUID"        , 0);
+    DisableItemsAboveGUID          = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveGUID"        , 0);
+    DisableItemsBelowReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqLevel"    , 0);
+    DisableItemsAboveReqLevel      = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqLevel"    , 0);
+    DisableItemsBelowReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqSkillRank", 0);
+    DisableItemsAboveReqSkillRank  = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqSkillRank", 0);
+
+    //
+    // Trade goods level and skills
+    //
+
+    DisableTGsBelowLevel           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowLevel"       , 0);
+    DisableTGsAboveLevel           = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveLevel"       , 0);
+    DisableTGsBelowGUID            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowGUID"        , 0);
+    DisableTGsAboveGUID            = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveGUID"        , 0);
+    DisableTGsBelowReqLevel        = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqLevel"    , 0);
+    DisableTGsAboveReqLevel        = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqLevel"    , 0);
+    DisableTGsBelowReqSkillRank    = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqSkillRank", 0);
+    DisableTGsAboveReqSkillRank    = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqSkillRank", 0);
+
+    //
+    // Whitelists
+    //
+
+    SellerWhiteList                = getCommaSeparatedIntegers(sConfigMgr->GetOption<std::string>("AuctionHouseBot.SellerWhiteList", ""));
+}
+
+void AHBConfig::InitializeFromSql(AHBSettings const& settings)
+{
+    if (settings.empty())
+    {
+        LOG_ERROR("module", "AHBot: No settings for auction house {} in mod_auctionhousebot", GetAHID());
+    }
+
+    //
+    // Load min and max items
+    //
+
+    SetMinItems(GetSetting(settings, "minitems"));
+    SetMaxItems(GetSetting(settings, "maxitems"));
+
+    //
+    // Load percentages
+    //
+
+    uint32 greytg   = GetSetting(settings, "percentgreytradegoods"  );
+    uint32 whitetg  = GetSetting(settings, "percentwhitetradegoods" );
+    uint32 greentg  = GetSetting(settings, "percentgreentradegoods" );
+    uint32 bluetg   = GetSetting(settings, "percentbluetradegoods"  );
+    uint32 purpletg = GetSetting(settings, "percentpurpletradegoods");
+    uint32 orangetg = GetSetting(settings, "percentorangetradegoods");
+    uint32 yellowtg = GetSetting(settings, "percentyellowtradegoods");
+
+    uint32 greyi    = GetSetting(settings, "percentgreyitems"       );
+    uint32 whitei   = GetSetting(settings, "percentwhiteitems"      );
+    uint32 greeni   = GetSetting(settings, "percentgreenitems"      );
+    uint32 bluei    = GetSetting(settings, "percentblueitems"       );
+    uint32 purplei  = GetSetting(settings, "percentpurpleitems"     );
+    uint32 orangei  = GetSetting(settings, "percentorangeitems"     );
+    uint32 yellowi  = GetSetting(settings, "percentyellowitems"     );
+
+    SetPercentages(greytg, whitetg, greentg, bluetg, purpletg, orangetg, yellowtg, greyi, whitei, greeni, bluei, purplei, orangei, yellowi);
+
+    // 
+    // Load min and max prices
+    // 
+
+    SetMinPrice(AHB_GREY  , GetSetting(settings, "minpricegrey"  ));
+    SetMaxPrice(AHB_GREY  , GetSetting(settings, "maxpricegrey"  ));
+    SetMinPrice(AHB_WHITE , GetSetting(settings, "minpricewhite" ));
+    SetMaxPrice(AHB_WHITE , GetSetting(settings, "maxpricewhite" ));
+    SetMinPrice(AHB_GREEN , GetSetting(settings, "minpricegreen" ));
+    SetMaxPrice(AHB_GREEN , GetSetting(settings, "maxpricegreen" ));
+    SetMinPrice(AHB_BLUE  , GetSetting(settings, "minpriceblue"  ));
+    SetMaxPrice(AHB_BLUE  , GetSetting(settings, "maxpriceblue"  ));
+    SetMinPrice(AHB_PURPLE, GetSetting(settings, "minpricepurple"));
+    SetMaxPrice(AHB_PURPLE, GetSetting(settings, "maxpricepurple"));
+    SetMinPrice(AHB_ORANGE, GetSetting(settings, "minpriceorange"));
+    SetMaxPrice(AHB_ORANGE, GetSetting(settings, "maxpriceorange"));
+    SetMinPrice(AHB_YELLOW, GetSetting(settings, "minpriceyellow"));
+    SetMaxPrice(AHB_YELLOW, GetSetting(settings, "maxpriceyellow"));
+
+    // 
+    // Load min and max bid prices
+    // 
+
+    SetMinBidPrice(AHB_GREY  , GetSetting(settings, "minbidpricegrey"  ));
+    SetMaxBidPrice(AHB_GREY  , GetSetting(settings, "maxbidpricegrey"  ));
+    SetMinBidPrice(AHB_WHITE , GetSetting(settings, "minbidpricewhite" ));
+    SetMaxBidPrice(AHB_WHITE , GetSetting(settings, "maxbidpricewhite" ));
+    SetMinBidPrice(AHB_GREEN , GetSetting(settings, "minbidpricegreen" ));
+    SetMaxBidPrice(AHB_GREEN , GetSetting(settings, "maxbidpricegreen" ));
+    SetMinBidPrice(AHB_BLUE  , GetSetting(settings, "minbidpriceblue"  ));
+    SetMaxBidPrice(AHB_BLUE  , GetSetting(settings, "maxbidpriceblue"  ));
+    SetMinBidPrice(AHB_PURPLE, GetSetting(settings, "minbidpricepurple"));
+    SetMaxBidPrice(AHB_PURPLE, GetSetting(settings, "maxbidpricepurple"));
+    SetMinBidPrice(AHB_ORANGE, GetSetting(settings, "minbidpriceorange"));
+    SetMaxBidPrice(AHB_ORANGE, GetSetting(settings, "maxbidpriceorange"));
+    SetMinBidPrice(AHB_YELLOW, GetSetting(settings, "minbidpriceyellow"));
+    SetMaxBidPrice(AHB_YELLOW, GetSetting(settings, "maxbidpriceyellow"));
+
+    // 
+    // Load max stacks
+    // 
+
+    SetMaxStack(AHB_GREY  , GetSetting(settings, "maxstackgrey"  ));
+    SetMaxStack(AHB_WHITE , GetSetting(settings, "maxstackwhite" ));
+    SetMaxStack(AHB_GREEN , GetSetting(settings, "maxstackgreen" ));
+    SetMaxStack(AHB_BLUE  , GetSetting(settings, "maxstackblue"  ));
+    SetMaxStack(AHB_PURPLE, GetSetting(settings, "maxstackpurple"));
+    SetMaxStack(AHB_ORANGE, GetSetting(settings, "maxstackorange"));
+    SetMaxStack(AHB_YELLOW, GetSetting(settings, "maxstackyellow"));
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "Settings for Auctionhouse {}", GetAHID());
+
+        LOG_INFO("module", "minItems                = {}", GetMinItems());
+        LOG_INFO("module", "maxItems                = {}", GetMaxItems());
+
+        LOG_INFO("module", "percentGreyTradeGoods   = {}", GetPercentages(AHB_GREY_TG));
+        LOG_INFO("module", "percentWhiteTradeGoods  = {}", GetPercentages(AHB_WHITE_TG));
+        LOG_INFO("module", "percentGreenTradeGoods  = {}", GetPercentages(AHB_GREEN_TG));
+        LOG_INFO("module", "percentBlueTradeGoods   = {}", GetPercentages(AHB_BLUE_TG));
+        LOG_INFO("module", "percentPurpleTradeGoods = {}", GetPercentages(AHB_PURPLE_TG));
+        LOG_INFO("module", "percentOrangeTradeGoods = {}", GetPercentages(AHB_ORANGE_TG));
+        LOG_INFO("module", "percentYellowTradeGoods = {}", GetPercentages(AHB_YELLOW_TG));
+        LOG_INFO("module", "percentGreyItems        = {}", GetPercentages(AHB_GREY_I));
+        LOG_INFO("module", "percentWhiteItems       = {}", GetPercentages(AHB_WHITE_I));
+        LOG_INFO("module", "percentGreenItems       = {}", GetPercentages(AHB_GREEN_I));
+        LOG_INFO("module", "percentBlueItems        = {}", GetPercentages(AHB_BLUE_I));
+        LOG_INFO("module", "percentPurpleItems      = {}", GetPercentages(AHB_PURPLE_I));
+        LOG_INFO("module", "percentOrangeItems      = {}", GetPercentages(AHB_ORANGE_I));
+        LOG_INFO("module", "percentYellowItems      = {}", GetPercentages(AHB_YELLOW_I));
+
+        LOG_INFO("module", "minPriceGrey            = {}", GetMinPrice(AHB_GREY));
+        LOG_INFO("module", "maxPriceGrey            = {}", GetMaxPrice(AHB_GREY));
+        LOG_INFO("module", "minPriceWhite           = {}", GetMinPrice(AHB_WHITE));
+        LOG_INFO("module", "maxPriceWhite           = {}", GetMaxPrice(AHB_WHITE));
+        LOG_INFO("module", "minPriceGreen           = {}", GetMinPrice(AHB_GREEN));
+        LOG_INFO("module", "maxPriceGreen           = {}", GetMaxPrice(AHB_GREEN));
+        LOG_INFO("module", "minPriceBlue            = {}", GetMinPrice(AHB_BLUE));
+        LOG_INFO("module", "maxPriceBlue            = {}", GetMaxPrice(AHB_BLUE));
+        LOG_INFO("module", "minPricePurple          = {}", GetMinPrice(AHB_PURPLE));
+        LOG_INFO("module", "maxPricePurple          = {}", GetMaxPrice(AHB_PURPLE));
+        LOG_INFO("module", "minPriceOrange          = {}", GetMinPrice(AHB_ORANGE));
+        LOG_INFO("module", "maxPriceOrange          = {}", GetMaxPrice(AHB_ORANGE));
+        LOG_INFO("module", "minPriceYellow          = {}", GetMinPrice(AHB_YELLOW));
+        LOG_INFO("module", "maxPriceYellow          = {}", GetMaxPrice(AHB_YELLOW));
+
+        LOG_INFO("module", "minBidPriceGrey         = {}", GetMinBidPrice(AHB_GREY));
+        LOG_INFO("module", "maxBidPriceGrey         = {}", GetMaxBidPrice(AHB_GREY));
+        LOG_INFO("module", "minBidPriceWhite        = {}", GetMinBidPrice(AHB_WHITE));
+        LOG_INFO("module", "maxBidPriceWhite        = {}", GetMaxBidPrice(AHB_WHITE));
+        LOG_INFO("module", "minBidPriceGreen        = {}", GetMinBidPrice(AHB_GREEN));
+        LOG_INFO("module", "maxBidPriceGreen        = {}", GetMaxBidPrice(AHB_GREEN));
+        LOG_INFO("module", "minBidPriceBlue         = {}", GetMinBidPrice(AHB_BLUE));
+        LOG_INFO("module", "maxBidPriceBlue         = {}", GetMinBidPrice(AHB_BLUE));
+        LOG_INFO("module", "minBidPricePurple       = {}", GetMinBidPrice(AHB_PURPLE));
+        LOG_INFO("module", "maxBidPricePurple       = {}", GetMaxBidPrice(AHB_PURPLE));
+        LOG_INFO("module", "minBidPriceOrange       = {}", GetMinBidPrice(AHB_ORANGE));
+        LOG_INFO("module", "maxBidPriceOrange       = {}", GetMaxBidPrice(AHB_ORANGE));
+        LOG_INFO("module", "minBidPriceYellow       = {}", GetMinBidPrice(AHB_YELLOW));
+        LOG_INFO("module", "maxBidPriceYellow       = {}", GetMaxBidPrice(AHB_YELLOW));
+
+        LOG_INFO("module", "maxStackGrey            = {}", GetMaxStack(AHB_GREY));
+        LOG_INFO("module", "maxStackWhite           = {}", GetMaxStack(AHB_WHITE));
+        LOG_INFO("module", "maxStackGreen           = {}", GetMaxStack(AHB_GREEN));
+        LOG_INFO("module", "maxStackBlue            = {}", GetMaxStack(AHB_BLUE));
+        LOG_INFO("module", "maxStackPurple          = {}", GetMaxStack(AHB_PURPLE));
+        LOG_INFO("module", "maxStackOrange          = {}", GetMaxStack(AHB_ORANGE));
+        LOG_INFO("module", "maxStackYellow          = {}", GetMaxStack(AHB_YELLOW));
+    }
+
+    //
+    // Auctions buyer
+    //
+
+    SetBuyerPrice(AHB_GREY  , GetSetting(settings, "buyerpricegrey"  ));
+    SetBuyerPrice(AHB_WHITE , GetSetting(settings, "buyerpricewhite" ));
+    SetBuyerPrice(AHB_GREEN , GetSetting(settings, "buyerpricegreen" ));
+    SetBuyerPrice(AHB_BLUE  , GetSetting(settings, "buyerpriceblue"  ));
+    SetBuyerPrice(AHB_PURPLE, GetSetting(settings, "buyerpricepurple"));
+    SetBuyerPrice(AHB_ORANGE, GetSetting(settings, "buyerpriceorange"));
+    SetBuyerPrice(AHB_YELLOW, GetSetting(settings, "buyerpriceyellow"));
+
+    //
+    // Load bidding interval
+    //
+
+    SetBiddingInterval(GetSetting(settings, "buyerbiddinginterval"));
+
+    //
+    // Load bids per interval
+    //
+
+    SetBidsPerInterval(GetSetting(settings, "buyerbidsperinterval"));
+
+    if (DebugOutConfig)
     {
         LOG_INFO("module", "Current Settings for Auctionhouse {} buyer", GetAHID());
         LOG_INFO("module", "buyerPriceGrey          = {}", GetBuyerPrice(AHB_GREY));
@@ -2482,6 +2916,63 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
         LOG_INFO("module", "Loaded {} items from the disabled item store", uint32(DisableItemStore.size()));
     }
 
+    //
+    // Reload the price overrides. The ranges are kept as they are, sorted, and looked up with a binary search;
+    // where they overlap the one starting first wins and the following ones are cut.
+    //
+
+    PriceOverrides.clear();
+
+    QueryResult overridesResult = WorldDatabase.Query("SELECT itemstart, itemend, minbuyout, maxbuyout, minbidratio, maxbidratio FROM mod_auctionhousebot_price_overrides ORDER BY itemstart, itemend");
+
+    if (overridesResult)
+    {
+        do
+        {
+            Field* fields = overridesResult->Fetch();
+
+            AHBPriceOverride priceOverride;
+
+            priceOverride.itemStart   = fields[0].Get<uint32>();
+            priceOverride.itemEnd     = fields[1].Get<uint32>();
+            priceOverride.minBuyout   = fields[2].Get<uint32>();
+            priceOverride.maxBuyout   = fields[3].Get<uint32>();
+            priceOverride.minBidRatio = fields[4].Get<uint32>();
+            priceOverride.maxBidRatio = fields[5].Get<uint32>();
+
+            if (priceOverride.itemEnd < priceOverride.itemStart || priceOverride.maxBuyout < priceOverride.minBuyout || priceOverride.maxBidRatio < priceOverride.minBidRatio)
+            {
+                LOG_ERROR("module", "AHBot: Invalid price override for items {}-{}, skipped", priceOverride.itemStart, priceOverride.itemEnd);
+                continue;
+            }
+
+            if (!PriceOverrides.empty() && priceOverride.itemStart <= PriceOverrides.back().itemEnd)
+            {
+                AHBPriceOverride const& previous = PriceOverrides.back();
+
+                if (priceOverride.itemEnd <= previous.itemEnd)
+                {
+                    LOG_ERROR("module", "AHBot: Price override for items {}-{} is covered by the one for items {}-{}, skipped", priceOverride.itemStart, priceOverride.itemEnd, previous.itemStart, previous.itemEnd);
+                    continue;
+                }
+
+                LOG_ERROR("module", "AHBot: Price override for items {}-{} overlaps the one for items {}-{}, it starts from item {}", priceOverride.itemStart, priceOverride.itemEnd, previous.itemStart, previous.itemEnd, previous.itemEnd + 1);
+
+                priceOverride.itemStart = previous.itemEnd + 1;
+            }
+
+            PriceOverrides.push_back(priceOverride);
+        } while (overridesResult->NextRow());
+    }
+
+    if (DebugOutConfig)
+    {
+        LOG_INFO("module", "Loaded {} ranges from the price overrides", uint32(PriceOverrides.size()));
+    }
+}
+
+void AHBConfig::InitializeItemSources()
+{
     // 
     // Reload the list of npc items
     // 
@@ -2577,835 +3068,590 @@ void AHBConfig::InitializeFromSql(std::set<uint32> botsIds)
     }
 }
 
-void AHBConfig::InitializeBins()
+void AHBConfig::InitializeBins(AHBConfig const* shared)
 {
     //
-    // Exclude items depending on the configuration; whatever passes all the tests is put in the lists.
+    // The catalog only depends on the filters: reuse the one of the given house when they are the same
     //
 
-    ItemTemplateContainer const* its = sObjectMgr->GetItemTemplateStore();
+    std::string signature = GetCatalogSignature();
 
-    for (ItemTemplateContainer::const_iterator itr = its->begin(); itr != its->end(); ++itr)
+    if (shared && shared != this && shared->Catalog && shared->catalogSignature == signature)
     {
+        Catalog          = shared->Catalog;
+        catalogSignature = signature;
 
-        //
-        // Exclude items with the blocked binding type
-        //
-
-        if (itr->second.Bonding == NO_BIND && !No_Bind)
+        if (DebugOutConfig)
         {
-            continue;
+            LOG_INFO("module", "AHBot: ah {} shares the item catalog of ah {}", AHID, shared->AHID);
         }
+    }
+    else
+    {
+        InitializeItemSources();
+        BuildCatalog();
 
-        if (itr->second.Bonding == BIND_WHEN_PICKED_UP && !Bind_When_Picked_Up)
-        {
-            continue;
-        }
+        catalogSignature = signature;
+    }
 
-        if (itr->second.Bonding == BIND_WHEN_EQUIPPED && !Bind_When_Equipped)
-        {
-            continue;
-        }
-
-        if (itr->second.Bonding == BIND_WHEN_USE && !Bind_When_Use)
-        {
-            continue;
-        }
-
-        if (itr->second.Bonding == BIND_QUEST_ITEM && !Bind_Quest_Item)
-        {
-            continue;
-        }
+    // 
+    // Perform reporting and the last check: if no items are disabled or in the whitelist clear the bin making the selling useless
+    // 
 
-        //
-        // Exclude items with no possible price
-        //
+    LOG_INFO("module", "AHBot: Configuration for ah {}", AHID);
 
-        if (SellMethod)
-        {
-            if (itr->second.BuyPrice == 0)
-            {
-                continue;
-            }
-        }
-        else
+    if (SellerWhiteList.size() == 0)
+    {
+        if (DisableItemStore.size() == 0)
         {
-            if (itr->second.SellPrice == 0)
-            {
-                continue;
-            }
-        }
-
-        //
-        // Exclude items with no costs associated, in any case
-        //
+            LOG_ERROR("module", "AHBot: No items are disabled or in the whitelist! Selling will be disabled!");
 
-        if ((itr->second.BuyPrice == 0) && (itr->second.SellPrice == 0))
-        {
-            continue;
-        }
+            Catalog = std::make_shared<AHBCatalog const>();
 
-        //
-        // Exlude items superior to the limit quality
-        //
+            AHBSeller = false;
 
-        if (itr->second.Quality > 6)
-        {
-            continue;
+            return;
         }
 
-        //
-        // Exclude trade goods items
-        //
+        LOG_INFO("module", "AHBot: {} disabled items", uint32(DisableItemStore.size()));
+    }
+    else
+    {
+        LOG_INFO("module", "AHBot: Using a whitelist of {} items", uint32(SellerWhiteList.size()));
+    }
 
-        if (itr->second.Class == ITEM_CLASS_TRADE_GOODS)
-        {
-            bool isNpc   = false;
-            bool isLoot  = false;
-            bool exclude = false;
+    LOG_INFO("module", "AHBot: loaded {} grey   trade goods", Catalog->GetCount(AHB_GREY_TG));
+    LOG_INFO("module", "AHBot: loaded {} white  trade goods", Catalog->GetCount(AHB_WHITE_TG));
+    LOG_INFO("module", "AHBot: loaded {} green  trade goods", Catalog->GetCount(AHB_GREEN_TG));
+    LOG_INFO("module", "AHBot: loaded {} blue   trade goods", Catalog->GetCount(AHB_BLUE_TG));
+    LOG_INFO("module", "AHBot: loaded {} purple trade goods", Catalog->GetCount(AHB_PURPLE_TG));
+    LOG_INFO("module", "AHBot: loaded {} orange trade goods", Catalog->GetCount(AHB_ORANGE_TG));
+    LOG_INFO("module", "AHBot: loaded {} yellow trade goods", Catalog->GetCount(AHB_YELLOW_TG));
+    LOG_INFO("module", "AHBot: loaded {} grey   items"      , Catalog->GetCount(AHB_GREY_I));
+    LOG_INFO("module", "AHBot: loaded {} white  items"      , Catalog->GetCount(AHB_WHITE_I));
+    LOG_INFO("module", "AHBot: loaded {} green  items"      , Catalog->GetCount(AHB_GREEN_I));
+    LOG_INFO("module", "AHBot: loaded {} blue   items"      , Catalog->GetCount(AHB_BLUE_I));
+    LOG_INFO("module", "AHBot: loaded {} purple items"      , Catalog->GetCount(AHB_PURPLE_I));
+    LOG_INFO("module", "AHBot: loaded {} orange items"      , Catalog->GetCount(AHB_ORANGE_I));
+    LOG_INFO("module", "AHBot: loaded {} yellow items"      , Catalog->GetCount(AHB_YELLOW_I));
+}
 
-            if (NpcItems.find(itr->second.ItemId) != NpcItems.end())
-            {
-                isNpc = true;
+void AHBConfig::InitializeBuyerValuations()
+{
+    //
+    // The most the buyer pays for one unit of every item: the vendor price scaled by the buyer price of its quality.
+    // Items of unsupported qualities and ammunitions are never bought.
+    //
 
-                if (!Vendor_TGs)
-                {
-                    exclude = true;
-                }
-            }
+    ItemTemplateContainer const* its   = sObjectMgr->GetItemTemplateStore();
+    uint32                       maxId = 0;
 
-            if (!exclude)
-            {
-                if (LootItems.find(itr->second.ItemId) != LootItems.end())
-                {
-                    isLoot = true;
+    for (ItemTemplateContainer::const_iterator itr = its->begin(); itr != its->end(); ++itr)
+    {
+        maxId = std::max(maxId, itr->second.ItemId);
+    }
 
-                    if (!Loot_TGs)
-                    {
-                        exclude = true;
-                    }
-                }
-            }
+    buyerValuations.assign(maxId + 1, AHBBuyerValuation());
 
-            if (exclude)
-            {
-                continue;
-            }
+    for (ItemTemplateContainer::const_iterator itr = its->begin(); itr != its->end(); ++itr)
+    {
+        ItemTemplate const* prototype = &itr->second;
+        AHBBuyerValuation&  valuation = buyerValuations[prototype->ItemId];
 
-            if (!Other_TGs)
-            {
-                if (!isNpc && !isLoot)
-                {
-                    continue;
-                }
-            }
+        if (prototype->Quality > AHB_MAX_QUALITY || prototype->Class == ITEM_CLASS_PROJECTILE)
+        {
+            continue;
         }
 
-        //
-        // Exclude loot items
-        //
+        uint64 unitPrice = BuyMethod ? prototype->SellPrice : prototype->BuyPrice;
 
-        if (itr->second.Class != ITEM_CLASS_TRADE_GOODS)
-        {
-            bool isNpc   = false;
-            bool isLoot  = false;
-            bool exclude = false;
+        valuation.maxUnitBid = unitPrice * GetBuyerPrice(prototype->Quality);
+        valuation.excluded   = valuation.maxUnitBid == 0;
+    }
 
-            if (NpcItems.find(itr->second.ItemId) != NpcItems.end())
-            {
-                isNpc = true;
+    //
+    // The deals are ranked against the valuations
+    //
 
-                if (!Vendor_Items)
-                {
-                    exclude = true;
-                }
-            }
+    RebuildBestDeals();
+}
 
-            if (!exclude)
-            {
-                if (LootItems.find(itr->second.ItemId) != LootItems.end())
-                {
-                    isLoot = true;
+void AHBConfig::BuildCatalog()
+{
+    //
+    // Exclude items depending on the configuration; whatever passes all the tests is put in the lists.
+    // The templates are sorted and split in contiguous chunks filtered in parallel, then merged in order,
+    // so that the result does not depend on the number of threads.
+    //
 
-                    if (!Loot_Items)
-                    {
-                        exclude = true;
-                    }
-                }
-            }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-            if (exclude)
-            {
-                continue;
-            }
+    ItemTemplateContainer const*      its = sObjectMgr->GetItemTemplateStore();
+    std::vector<ItemTemplate const*> templates;
 
-            if (!Other_Items)
-            {
-                if (!isNpc && !isLoot)
-                {
-                    continue;
-                }
-            }
-        }
+    templates.reserve(its->size());
 
-        //
-        // Verify if the item is disabled or not in the whitelist
-        //
+    for (ItemTemplateContainer::const_iterator itr = its->begin(); itr != its->end(); ++itr)
+    {
+        templates.push_back(&itr->second);
+    }
 
-        if (SellerWhiteList.size() == 0)
-        {
-            if (DisableItemStore.find(itr->second.ItemId) != DisableItemStore.end())
-            {
-                if (DebugOutFilters)
-                {
-                    LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (PTR/Beta/Unused Item)", itr->second.ItemId);
-                }
+    std::sort(templates.begin(), templates.end(), [](ItemTemplate const* a, ItemTemplate const* b)
+    {
+        return a->ItemId < b->ItemId;
+    });
 
-                continue;
-            }
-        }
-        else
-        {
-            if (SellerWhiteList.find(itr->second.ItemId) == SellerWhiteList.end())
-            {
-                if (DebugOutFilters)
-                {
-                    LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (not in the whitelist)", itr->second.ItemId);
-                }
+    uint32 threads = InitializationThreads;
 
-                continue;
-            }
-        }
+    if (threads == 0)
+    {
+        threads = std::max<uint32>(1, std::thread::hardware_concurrency());
+    }
 
-        //
-        // Disable permanent enchants items
-        //
+    threads = std::max<uint32>(1, std::min<uint32>(threads, uint32(templates.size() / AHB_MIN_ITEMS_PER_THREAD) + 1));
 
-        if ((DisablePermEnchant) && (itr->second.Class == ITEM_CLASS_PERMANENT))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Permanent Enchant Item)", itr->second.ItemId);
-            }
+    //
+    // Compile the enabled filters once, most selective first
+    //
 
-            continue;
-        }
+    std::vector<AHBItemFilter> filters = CompileFilters();
 
-        //
-        // Disable conjured items
-        //
+    SortFilters(filters, templates);
 
-        if ((DisableConjured) && (itr->second.IsConjuredConsumable()))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Conjured Consumable)", itr->second.ItemId);
-            }
+    std::vector<std::vector<ItemTemplate const*>> accepted(threads);
+    std::vector<std::vector<uint32>> rejected(threads, std::vector<uint32>(filters.size(), 0));
+    std::vector<std::chrono::steady_clock::duration> elapsed(threads);
 
-            continue;
-        }
+    auto filterChunk = [this, &templates, &filters, &accepted, &rejected, &elapsed, threads](uint32 chunk)
+    {
+        std::chrono::steady_clock::time_point chunkStart = std::chrono::steady_clock::now();
 
-        //
-        // Disable gems
-        //
+        size_t first = templates.size() * chunk / threads;
+        size_t last  = templates.size() * (chunk + 1) / threads;
 
-        if ((DisableGems) && (itr->second.Class == ITEM_CLASS_GEM))
+        for (size_t i = first; i < last; ++i)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Gem)", itr->second.ItemId);
-            }
-
-            continue;
-        }
-
-        //
-        // Disable money
-        //
+            bool sellable = true;
 
-        if ((DisableMoney) && (itr->second.Class == ITEM_CLASS_MONEY))
-        {
-            if (DebugOutFilters)
+            for (size_t filter = 0; filter < filters.size(); ++filter)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Money)", itr->second.ItemId);
-            }
-
-            continue;
-        }
+                if (filters[filter].rejects(templates[i]))
+                {
+                    ++rejected[chunk][filter];
 
-        //
-        // Disable moneyloot
-        //
+                    if (DebugOutFilters)
+                    {
+                        LOG_ERROR("module", "AuctionHouseBot: Item {} disabled ({})", templates[i]->ItemId, filters[filter].name);
+                    }
 
-        if ((DisableMoneyLoot) && (itr->second.MinMoneyLoot > 0))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (MoneyLoot)", itr->second.ItemId);
+                    sellable = false;
+                    break;
+                }
             }
 
-            continue;
-        }
-
-        //
-        // Disable lootable items
-        //
-
-        if ((DisableLootable) && (itr->second.Flags & 4))
-        {
-            if (DebugOutFilters)
+            if (sellable)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Lootable Item)", itr->second.ItemId);
+                accepted[chunk].push_back(templates[i]);
             }
-
-            continue;
         }
 
-        //
-        // Disable Keys
-        //
+        elapsed[chunk] = std::chrono::steady_clock::now() - chunkStart;
+    };
 
-        if ((DisableKeys) && (itr->second.Class == ITEM_CLASS_KEY))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Quest Item)", itr->second.ItemId);
-            }
+    std::vector<std::thread> workers;
 
-            continue;
-        }
+    for (uint32 chunk = 1; chunk < threads; ++chunk)
+    {
+        workers.emplace_back(filterChunk, chunk);
+    }
 
-        //
-        // Disable items with duration
-        //
+    filterChunk(0);
 
-        if ((DisableDuration) && (itr->second.Duration > 0))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Has a Duration)", itr->second.ItemId);
-            }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
 
-            continue;
-        }
+    //
+    // Merge the results
+    //
 
-        //
-        // Disable items which are BOP or Quest Items and have a required level lower than the item level
-        //
+    std::shared_ptr<AHBCatalog> catalog = std::make_shared<AHBCatalog>();
 
-        if ((DisableBOP_Or_Quest_NoReqLevel) && ((itr->second.Bonding == BIND_WHEN_PICKED_UP || itr->second.Bonding == BIND_QUEST_ITEM) && (itr->second.RequiredLevel < itr->second.ItemLevel)))
+    for (uint32 chunk = 0; chunk < threads; ++chunk)
+    {
+        for (ItemTemplate const* prototype : accepted[chunk])
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (BOP or BQI and Required Level is less than Item Level)", itr->second.ItemId);
-            }
-
-            continue;
+            catalog->Add(AHBCatalog::GetCategory(prototype), prototype);
         }
+    }
 
-        //
-        // Disable items specifically for Warrior
-        //
-
-        if ((DisableWarriorItems) && (itr->second.AllowableClass == AHB_CLASS_WARRIOR))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Warrior Item)", itr->second.ItemId);
-            }
+    Catalog = catalog;
 
-            continue;
-        }
+    //
+    // The sources are only needed while filtering
+    //
 
-        //
-        // Disable items specifically for Paladin
-        //
+    NpcItems.clear();
+    LootItems.clear();
 
-        if ((DisablePaladinItems) && (itr->second.AllowableClass == AHB_CLASS_PALADIN))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Paladin Item)", itr->second.ItemId);
-            }
+    //
+    // Report the time saved compared to filtering all the chunks one after the other
+    //
 
-            continue;
-        }
+    std::chrono::steady_clock::duration sequential = std::chrono::steady_clock::duration::zero();
 
-        //
-        // Disable items specifically for Hunter
-        //
+    for (std::chrono::steady_clock::duration chunkElapsed : elapsed)
+    {
+        sequential += chunkElapsed;
+    }
 
-        if ((DisableHunterItems) && (itr->second.AllowableClass == AHB_CLASS_HUNTER))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Hunter Item)", itr->second.ItemId);
-            }
+    std::chrono::steady_clock::duration wall = std::chrono::steady_clock::now() - start;
 
-            continue;
-        }
+    uint64 wallMs  = uint64(std::chrono::duration_cast<std::chrono::milliseconds>(wall).count());
+    uint64 savedMs = sequential > wall ? uint64(std::chrono::duration_cast<std::chrono::milliseconds>(sequential - wall).count()) : 0;
 
-        //
-        // Disable items specifically for Rogue
-        //
+    LOG_INFO("module", "AHBot: Built the item catalog for ah {} from {} templates with {} threads in {} ms ({} ms saved)", AHID, uint32(templates.size()), threads, wallMs, savedMs);
 
-        if ((DisableRogueItems) && (itr->second.AllowableClass == AHB_CLASS_ROGUE))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Rogue Item)", itr->second.ItemId);
-            }
+    //
+    // Report how many items every filter rejected, in the order they were applied
+    //
 
-            continue;
-        }
+    std::ostringstream summary;
 
-        //
-        // Disable items specifically for Priest
-        //
+    for (size_t filter = 0; filter < filters.size(); ++filter)
+    {
+        uint32 count = 0;
 
-        if ((DisablePriestItems) && (itr->second.AllowableClass == AHB_CLASS_PRIEST))
+        for (uint32 chunk = 0; chunk < threads; ++chunk)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Priest Item)", itr->second.ItemId);
-            }
-
-            continue;
+            count += rejected[chunk][filter];
         }
 
-        //
-        // Disable items specifically for DK
-        //
-
-        if ((DisableDKItems) && (itr->second.AllowableClass == AHB_CLASS_DK))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (DK Item)", itr->second.ItemId);
-            }
-
-            continue;
-        }
+        summary << (filter ? ", " : "") << filters[filter].name << "=" << count;
+    }
 
-        //
-        // Disable items specifically for Shaman
-        //
+    LOG_INFO("module", "AHBot: Filters rejected for ah {}: {}", AHID, summary.str());
+}
 
-        if ((DisableShamanItems) && (itr->second.AllowableClass == AHB_CLASS_SHAMAN))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Shaman Item)", itr->second.ItemId);
-            }
+std::vector<AHBItemFilter> AHBConfig::CompileFilters() const
+{
+    //
+    // Only the tests enabled by the configuration are compiled; every one of them rejects an item when it returns true.
+    // The settings are captured by value, the item sources by reference as they live until the catalog is built.
+    //
 
-            continue;
-        }
+    std::vector<AHBItemFilter> filters;
 
-        //
-        // Disable items specifically for Mage
-        //
+    //
+    // Exclude items with no possible price; items with no costs at all are rejected by both the methods
+    //
 
-        if ((DisableMageItems) && (itr->second.AllowableClass == AHB_CLASS_MAGE))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Mage Item)", itr->second.ItemId);
-            }
+    if (SellMethod)
+    {
+        filters.push_back({ "no buy price", [](ItemTemplate const* prototype) { return prototype->BuyPrice == 0; } });
+    }
+    else
+    {
+        filters.push_back({ "no sell price", [](ItemTemplate const* prototype) { return prototype->SellPrice == 0; } });
+    }
 
-            continue;
-        }
+    //
+    // Exlude items superior to the limit quality
+    //
 
-        //
-        // Disable items specifically for Warlock
-        //
+    filters.push_back({ "quality", [](ItemTemplate const* prototype) { return prototype->Quality > AHB_MAX_QUALITY; } });
 
-        if ((DisableWarlockItems) && (itr->second.AllowableClass == AHB_CLASS_WARLOCK))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Warlock Item)", itr->second.ItemId);
-            }
+    //
+    // Exclude items with the blocked binding types
+    //
 
-            continue;
-        }
+    uint32 blockedBindings = 0;
 
-        //
-        // Disable items specifically for Unused Class
-        //
+    blockedBindings |= No_Bind             ? 0 : 1 << NO_BIND;
+    blockedBindings |= Bind_When_Picked_Up ? 0 : 1 << BIND_WHEN_PICKED_UP;
+    blockedBindings |= Bind_When_Equipped  ? 0 : 1 << BIND_WHEN_EQUIPPED;
+    blockedBindings |= Bind_When_Use       ? 0 : 1 << BIND_WHEN_USE;
+    blockedBindings |= Bind_Quest_Item     ? 0 : 1 << BIND_QUEST_ITEM;
 
-        if ((DisableUnusedClassItems) && (itr->second.AllowableClass == AHB_CLASS_UNUSED))
+    if (blockedBindings)
+    {
+        filters.push_back({ "binding", [blockedBindings](ItemTemplate const* prototype)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Unused Item)", itr->second.ItemId);
-            }
-
-            continue;
-        }
+            return prototype->Bonding <= BIND_QUEST_ITEM && (blockedBindings & (1 << prototype->Bonding));
+        } });
+    }
 
-        //
-        // Disable items specifically for Druid
-        //
+    //
+    // Exclude items depending on where they come from: vendors, loot or anywhere else
+    //
 
-        if ((DisableDruidItems) && (itr->second.AllowableClass == AHB_CLASS_DRUID))
+    auto addSource = [this, &filters](char const* name, bool tradeGoods, bool vendor, bool loot, bool other)
+    {
+        if (vendor && loot && other)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Druid Item)", itr->second.ItemId);
-            }
-
-            continue;
+            return;
         }
 
-        //
-        // Disable Items below level X
-        //
+        std::set<uint32> const& npcItems  = NpcItems;
+        std::set<uint32> const& lootItems = LootItems;
 
-        if ((DisableItemsBelowLevel) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemLevel < DisableItemsBelowLevel))
+        filters.push_back({ name, [&npcItems, &lootItems, tradeGoods, vendor, loot, other](ItemTemplate const* prototype)
         {
-            if (DebugOutFilters)
+            if ((prototype->Class == ITEM_CLASS_TRADE_GOODS) != tradeGoods)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Item Level = {})", itr->second.ItemId, itr->second.ItemLevel);
+                return false;
             }
 
-            continue;
-        }
-
-        //
-        // Disable Items above level X
-        //
+            bool isNpc = npcItems.find(prototype->ItemId) != npcItems.end();
 
-        if ((DisableItemsAboveLevel) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemLevel > DisableItemsAboveLevel))
-        {
-            if (DebugOutFilters)
+            if (isNpc && !vendor)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Item Level = {})", itr->second.ItemId, itr->second.ItemLevel);
+                return true;
             }
 
-            continue;
-        }
-
-        //
-        // Disable Trade Goods below level X
-        //
+            bool isLoot = lootItems.find(prototype->ItemId) != lootItems.end();
 
-        if ((DisableTGsBelowLevel) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemLevel < DisableTGsBelowLevel))
-        {
-            if (DebugOutFilters)
+            if (isLoot && !loot)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Trade Good {} disabled (Trade Good Level = {})", itr->second.ItemId, itr->second.ItemLevel);
+                return true;
             }
 
-            continue;
-        }
-
-        //
-        // Disable Trade Goods above level X
-        //
-
-        if ((DisableTGsAboveLevel) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemLevel > DisableTGsAboveLevel))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Trade Good {} disabled (Trade Good Level = {})", itr->second.ItemId, itr->second.ItemLevel);
-            }
+            return !other && !isNpc && !isLoot;
+        } });
+    };
 
-            continue;
-        }
+    addSource("trade goods source", true , Vendor_TGs  , Loot_TGs  , Other_TGs  );
+    addSource("items source"      , false, Vendor_Items, Loot_Items, Other_Items);
 
-        //
-        // Disable Items below GUID X
-        //
+    //
+    // Verify if the item is disabled or not in the whitelist
+    //
 
-        if ((DisableItemsBelowGUID) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemId < DisableItemsBelowGUID))
+    if (SellerWhiteList.size() == 0)
+    {
+        if (DisableItemStore.size() > 0)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Item Level = {})", itr->second.ItemId, itr->second.ItemLevel);
-            }
-
-            continue;
-        }
-
-        //
-        // Disable Items above GUID X
-        //
+            std::set<uint32> const& disabled = DisableItemStore;
 
-        if ((DisableItemsAboveGUID) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemId > DisableItemsAboveGUID))
-        {
-            if (DebugOutFilters)
+            filters.push_back({ "disabled", [&disabled](ItemTemplate const* prototype)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Item Level = {})", itr->second.ItemId, itr->second.ItemLevel);
-            }
-
-            continue;
+                return disabled.find(prototype->ItemId) != disabled.end();
+            } });
         }
+    }
+    else
+    {
+        std::set<uint32> const& whiteList = SellerWhiteList;
 
-        //
-        // Disable Trade Goods below GUID X
-        //
-
-        if ((DisableTGsBelowGUID) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemId < DisableTGsBelowGUID))
+        filters.push_back({ "not whitelisted", [&whiteList](ItemTemplate const* prototype)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Trade Good Level = {})", itr->second.ItemId, itr->second.ItemLevel);
-            }
-
-            continue;
-        }
-
-        //
-        // Disable Trade Goods above GUID X
-        //
+            return whiteList.find(prototype->ItemId) == whiteList.end();
+        } });
+    }
 
-        if ((DisableTGsAboveGUID) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.ItemId > DisableTGsAboveGUID))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (Trade Good Level = {})", itr->second.ItemId, itr->second.ItemLevel);
-            }
+    //
+    // Item kinds
+    //
 
-            continue;
-        }
+    if (DisablePermEnchant)
+    {
+        filters.push_back({ "permanent enchant", [](ItemTemplate const* prototype) { return prototype->Class == ITEM_CLASS_PERMANENT; } });
+    }
 
-        //
-        // Disable Items for level lower than X
-        //
+    if (DisableConjured)
+    {
+        filters.push_back({ "conjured", [](ItemTemplate const* prototype) { return prototype->IsConjuredConsumable(); } });
+    }
 
-        if ((DisableItemsBelowReqLevel) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredLevel < DisableItemsBelowReqLevel))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (RequiredLevel = {})", itr->second.ItemId, itr->second.RequiredLevel);
-            }
+    if (DisableGems)
+    {
+        filters.push_back({ "gem", [](ItemTemplate const* prototype) { return prototype->Class == ITEM_CLASS_GEM; } });
+    }
 
-            continue;
-        }
+    if (DisableMoney)
+    {
+        filters.push_back({ "money", [](ItemTemplate const* prototype) { return prototype->Class == ITEM_CLASS_MONEY; } });
+    }
 
-        //
-        // Disable Items for level higher than X
-        //
+    if (DisableMoneyLoot)
+    {
+        filters.push_back({ "money loot", [](ItemTemplate const* prototype) { return prototype->MinMoneyLoot > 0; } });
+    }
 
-        if ((DisableItemsAboveReqLevel) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredLevel > DisableItemsAboveReqLevel))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (RequiredLevel = {})", itr->second.ItemId, itr->second.RequiredLevel);
-            }
+    if (DisableLootable)
+    {
+        filters.push_back({ "lootable", [](ItemTemplate const* prototype) { return (prototype->Flags & 4) != 0; } });
+    }
 
-            continue;
-        }
+    if (DisableKeys)
+    {
+        filters.push_back({ "key", [](ItemTemplate const* prototype) { return prototype->Class == ITEM_CLASS_KEY; } });
+    }
 
-        //
-        // Disable Trade Goods for level lower than X
-        //
+    if (DisableDuration)
+    {
+        filters.push_back({ "duration", [](ItemTemplate const* prototype) { return prototype->Duration > 0; } });
+    }
 
-        if ((DisableTGsBelowReqLevel) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredLevel < DisableTGsBelowReqLevel))
+    if (DisableBOP_Or_Quest_NoReqLevel)
+    {
+        filters.push_back({ "bop or quest without level", [](ItemTemplate const* prototype)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Trade Good {} disabled (RequiredLevel = {})", itr->second.ItemId, itr->second.RequiredLevel);
-            }
-
-            continue;
-        }
-
-        //
-        // Disable Trade Goods for level higher than X
-        //
+            return (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM) && (prototype->RequiredLevel < prototype->ItemLevel);
+        } });
+    }
 
-        if ((DisableTGsAboveReqLevel) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredLevel > DisableTGsAboveReqLevel))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Trade Good {} disabled (RequiredLevel = {})", itr->second.ItemId, itr->second.RequiredLevel);
-            }
+    //
+    // Items usable by one disabled class only; the class masks have a single bit set
+    //
 
-            continue;
-        }
+    uint32 blockedClasses = 0;
 
-        //
-        // Disable Items that require skill lower than X
-        //
+    blockedClasses |= DisableWarriorItems     ? AHB_CLASS_WARRIOR : 0;
+    blockedClasses |= DisablePaladinItems     ? AHB_CLASS_PALADIN : 0;
+    blockedClasses |= DisableHunterItems      ? AHB_CLASS_HUNTER  : 0;
+    blockedClasses |= DisableRogueItems       ? AHB_CLASS_ROGUE   : 0;
+    blockedClasses |= DisablePriestItems      ? AHB_CLASS_PRIEST  : 0;
+    blockedClasses |= DisableDKItems          ? AHB_CLASS_DK      : 0;
+    blockedClasses |= DisableShamanItems      ? AHB_CLASS_SHAMAN  : 0;
+    blockedClasses |= DisableMageItems        ? AHB_CLASS_MAGE    : 0;
+    blockedClasses |= DisableWarlockItems     ? AHB_CLASS_WARLOCK : 0;
+    blockedClasses |= DisableUnusedClassItems ? AHB_CLASS_UNUSED  : 0;
+    blockedClasses |= DisableDruidItems       ? AHB_CLASS_DRUID   : 0;
 
-        if ((DisableItemsBelowReqSkillRank) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredSkillRank < DisableItemsBelowReqSkillRank))
+    if (blockedClasses)
+    {
+        filters.push_back({ "class", [blockedClasses](ItemTemplate const* prototype)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itr->second.ItemId, itr->second.RequiredSkillRank);
-            }
+            uint32 allowable = uint32(prototype->AllowableClass);
 
-            continue;
-        }
+            return allowable != 0 && (allowable & (allowable - 1)) == 0 && (blockedClasses & allowable);
+        } });
+    }
 
-        //
-        // Disable Items that require skill higher than X
-        //
+    //
+    // Level, GUID, required level and required skill bounds; a bound set to 0 is disabled
+    //
 
-        if ((DisableItemsAboveReqSkillRank) && (itr->second.Class != ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredSkillRank > DisableItemsAboveReqSkillRank))
+    auto addBound = [&filters](std::string name, bool tradeGoods, uint32 ItemTemplate::* field, uint32 bound, bool below)
+    {
+        if (bound == 0)
         {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itr->second.ItemId, itr->second.RequiredSkillRank);
-            }
-
-            continue;
+            return;
         }
 
-        //
-        // Disable Trade Goods that require skill lower than X
-        //
-
-        if ((DisableTGsBelowReqSkillRank) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredSkillRank < DisableTGsBelowReqSkillRank))
+        filters.push_back({ name + (below ? " < " : " > ") + std::to_string(bound), [tradeGoods, field, bound, below](ItemTemplate const* prototype)
         {
-            if (DebugOutFilters)
+            if ((prototype->Class == ITEM_CLASS_TRADE_GOODS) != tradeGoods)
             {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itr->second.ItemId, itr->second.RequiredSkillRank);
+                return false;
             }
 
-            continue;
-        }
-
-        //
-        // Disable Trade Goods that require skill higher than X
-        //
-
-        if ((DisableTGsAboveReqSkillRank) && (itr->second.Class == ITEM_CLASS_TRADE_GOODS) && (itr->second.RequiredSkillRank > DisableTGsAboveReqSkillRank))
-        {
-            if (DebugOutFilters)
-            {
-                LOG_ERROR("module", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itr->second.ItemId, itr->second.RequiredSkillRank);
-            }
+            return below ? prototype->*field < bound : prototype->*field > bound;
+        } });
+    };
+
+    addBound("item level"             , false, &ItemTemplate::ItemLevel        , DisableItemsBelowLevel       , true );
+    addBound("item level"             , false, &ItemTemplate::ItemLevel        , DisableItemsAboveLevel       , false);
+    addBound("trade good level"       , true , &ItemTemplate::ItemLevel        , DisableTGsBelowLevel         , true );
+    addBound("trade good level"       , true , &ItemTemplate::ItemLevel        , DisableTGsAboveLevel         , false);
+    addBound("item guid"              , false, &ItemTemplate::ItemId           , DisableItemsBelowGUID        , true );
+    addBound("item guid"              , false, &ItemTemplate::ItemId           , DisableItemsAboveGUID        , false);
+    addBound("trade good guid"        , true , &ItemTemplate::ItemId           , DisableTGsBelowGUID          , true );
+    addBound("trade good guid"        , true , &ItemTemplate::ItemId           , DisableTGsAboveGUID          , false);
+    addBound("item req level"         , false, &ItemTemplate::RequiredLevel    , DisableItemsBelowReqLevel    , true );
+    addBound("item req level"         , false, &ItemTemplate::RequiredLevel    , DisableItemsAboveReqLevel    , false);
+    addBound("trade good req level"   , true , &ItemTemplate::RequiredLevel    , DisableTGsBelowReqLevel      , true );
+    addBound("trade good req level"   , true , &ItemTemplate::RequiredLevel    , DisableTGsAboveReqLevel      , false);
+    addBound("item req skill"         , false, &ItemTemplate::RequiredSkillRank, DisableItemsBelowReqSkillRank, true );
+    addBound("item req skill"         , false, &ItemTemplate::RequiredSkillRank, DisableItemsAboveReqSkillRank, false);
+    addBound("trade good req skill"   , true , &ItemTemplate::RequiredSkillRank, DisableTGsBelowReqSkillRank  , true );
+    addBound("trade good req skill"   , true , &ItemTemplate::RequiredSkillRank, DisableTGsAboveReqSkillRank  , false);
+
+    return filters;
+}
 
-            continue;
-        }
+void AHBConfig::SortFilters(std::vector<AHBItemFilter>& filters, std::vector<ItemTemplate const*> const& templates) const
+{
+    //
+    // Measure how many templates every filter rejects on its own over an evenly spread sample,
+    // then run the most selective ones first so that most items leave the chain after a test or two.
+    //
 
-        //
-        // Now that the items passed all the tests, organize it by quality
-        //
+    std::vector<uint32> rejected(filters.size(), 0);
 
-        if (itr->second.Class == ITEM_CLASS_TRADE_GOODS)
+    for (size_t i = 0; i < templates.size(); i += AHB_FILTER_SAMPLE_STEP)
+    {
+        for (size_t filter = 0; filter < filters.size(); ++filter)
         {
-            switch (itr->second.Quality)
+            if (filters[filter].rejects(templates[i]))
             {
-            case AHB_GREY:
-                GreyTradeGoodsBin.insert(itr->second.ItemId);
-                break;
-
-            case AHB_WHITE:
-                WhiteTradeGoodsBin.insert(itr->second.ItemId);
-                break;
-
-            case AHB_GREEN:
-                GreenTradeGoodsBin.insert(itr->second.ItemId);
-                break;
-
-            case AHB_BLUE:
-                BlueTradeGoodsBin.insert(itr->second.ItemId);
-                break;
-
-            case AHB_PURPLE:
-                PurpleTradeGoodsBin.insert(itr->second.ItemId);
-                break;
-
-            case AHB_ORANGE:
-                OrangeTradeGoodsBin.insert(itr->second.ItemId);
-                break;
-
-            case AHB_YELLOW:
-                YellowTradeGoodsBin.insert(itr->second.ItemId);
-                break;
+                ++rejected[filter];
             }
         }
-        else
-        {
-            switch (itr->second.Quality)
-            {
-            case AHB_GREY:
-                GreyItemsBin.insert(itr->second.ItemId);
-                break;
+    }
 
-            case AHB_WHITE:
-                WhiteItemsBin.insert(itr->second.ItemId);
-                break;
+    std::vector<size_t> order(filters.size());
 
-            case AHB_GREEN:
-                GreenItemsBin.insert(itr->second.ItemId);
-                break;
+    for (size_t filter = 0; filter < filters.size(); ++filter)
+    {
+        order[filter] = filter;
+    }
 
-            case AHB_BLUE:
-                BlueItemsBin.insert(itr->second.ItemId);
-                break;
+    std::stable_sort(order.begin(), order.end(), [&rejected](size_t a, size_t b)
+    {
+        return rejected[a] > rejected[b];
+    });
 
-            case AHB_PURPLE:
-                PurpleItemsBin.insert(itr->second.ItemId);
-                break;
+    std::vector<AHBItemFilter> sorted;
 
-            case AHB_ORANGE:
-                OrangeItemsBin.insert(itr->second.ItemId);
-                break;
+    sorted.reserve(filters.size());
 
-            case AHB_YELLOW:
-                YellowItemsBin.insert(itr->second.ItemId);
-                break;
-            }
-        }
+    for (size_t filter : order)
+    {
+        sorted.push_back(std::move(filters[filter]));
     }
 
-    // 
-    // Perform reporting and the last check: if no items are disabled or in the whitelist clear the bin making the selling useless
-    // 
-
-    LOG_INFO("module", "AHBot: Configuration for ah {}", AHID);
+    filters.swap(sorted);
+}
 
-    if (SellerWhiteList.size() == 0)
-    {
-        if (DisableItemStore.size() == 0)
-        {
-            LOG_ERROR("module", "AHBot: No items are disabled or in the whitelist! Selling will be disabled!");
+std::string AHBConfig::GetCatalogSignature()
+{
+    std::ostringstream signature;
 
-            GreyTradeGoodsBin.clear();
-            WhiteTradeGoodsBin.clear();
-            GreenTradeGoodsBin.clear();
-            BlueTradeGoodsBin.clear();
-            PurpleTradeGoodsBin.clear();
-            OrangeTradeGoodsBin.clear();
-            YellowTradeGoodsBin.clear();
-            GreyItemsBin.clear();
-            WhiteItemsBin.clear();
-            GreenItemsBin.clear();
-            BlueItemsBin.clear();
-            PurpleItemsBin.clear();
-            OrangeItemsBin.clear();
-            YellowItemsBin.clear();
+    signature << SellMethod << Vendor_Items << Loot_Items << Other_Items << Vendor_TGs << Loot_TGs << Other_TGs << Profession_Items
+              << No_Bind << Bind_When_Picked_Up << Bind_When_Equipped << Bind_When_Use << Bind_Quest_Item
+              << DisablePermEnchant << DisableConjured << DisableGems << DisableMoney << DisableMoneyLoot << DisableLootable
+              << DisableKeys << DisableDuration << DisableBOP_Or_Quest_NoReqLevel
+              << DisableWarriorItems << DisablePaladinItems << DisableHunterItems << DisableRogueItems << DisablePriestItems
+              << DisableDKItems << DisableShamanItems << DisableMageItems << DisableWarlockItems << DisableUnusedClassItems
+              << DisableDruidItems;
 
-            AHBSeller = false;
+    signature << ':' << DisableItemsBelowLevel        << ':' << DisableItemsAboveLevel
+              << ':' << DisableTGsBelowLevel          << ':' << DisableTGsAboveLevel
+              << ':' << DisableItemsBelowGUID         << ':' << DisableItemsAboveGUID
+              << ':' << DisableTGsBelowGUID           << ':' << DisableTGsAboveGUID
+              << ':' << DisableItemsBelowReqLevel     << ':' << DisableItemsAboveReqLevel
+              << ':' << DisableTGsBelowReqLevel       << ':' << DisableTGsAboveReqLevel
+              << ':' << DisableItemsBelowReqSkillRank << ':' << DisableItemsAboveReqSkillRank
+              << ':' << DisableTGsBelowReqSkillRank   << ':' << DisableTGsAboveReqSkillRank;
 
-            return;
-        }
+    signature << ":w";
 
-        LOG_INFO("module", "AHBot: {} disabled items", uint32(DisableItemStore.size()));
+    for (uint32 id : SellerWhiteList)
+    {
+        signature << ',' << id;
     }
-    else
+
+    signature << ":d";
+
+    for (uint32 id : DisableItemStore)
     {
-        LOG_INFO("module", "AHBot: Using a whitelist of {} items", uint32(SellerWhiteList.size()));
+        signature << ',' << id;
     }
 
-    LOG_INFO("module", "AHBot: loaded {} grey   trade goods", uint32(GreyTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} white  trade goods", uint32(WhiteTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} green  trade goods", uint32(GreenTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} blue   trade goods", uint32(BlueTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} purple trade goods", uint32(PurpleTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} orange trade goods", uint32(OrangeTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} yellow trade goods", uint32(YellowTradeGoodsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} grey   items"      , uint32(GreyItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} white  items"      , uint32(WhiteItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} green  items"      , uint32(GreenItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} blue   items"      , uint32(BlueItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} purple items"      , uint32(PurpleItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} orange items"      , uint32(OrangeItemsBin.size()));
-    LOG_INFO("module", "AHBot: loaded {} yellow items"      , uint32(YellowItemsBin.size()));
+    return signature.str();
 }
 
 std::set<uint32> AHBConfig::getCommaSeparatedIntegers(std::string text)
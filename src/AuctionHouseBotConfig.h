@@ -20,12 +20,95 @@
 #ifndef AUCTION_HOUSE_BOT_CONFIG_H
 #define AUCTION_HOUSE_BOT_CONFIG_H
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "AuctionHouseMgr.h"
 #include "ObjectMgr.h"
 
+#include "AuctionHouseBotCandidates.h"
+#include "AuctionHouseBotCatalog.h"
+
+//
+// Minimum amount of item templates worth a thread when building the catalog
+//
+
+#define AHB_MIN_ITEMS_PER_THREAD 4096
+
+//
+// One item template every AHB_FILTER_SAMPLE_STEP is used to measure how selective the filters are
+//
+
+#define AHB_FILTER_SAMPLE_STEP   16
+
+//
+// How the buyer chooses the auctions to bid on
+//
+
+#define AHB_BUYER_RANDOM         0
+#define AHB_BUYER_BEST_DEAL      1
+#define AHB_BUYER_EXPIRING       2
+
+//
+// Where the buyer takes the auctions it may bid on
+//
+
+#define AHB_CANDIDATES_MEMORY    0
+#define AHB_CANDIDATES_DATABASE  1
+
+//
+// Auctions the buyer may put back in the best deals for each one it draws, so that a draw stops early when most of
+// them are no longer deals
+//
+
+#define AHB_BUYER_EXAMINED_PER_DRAW 4
+
+//
+// Fixed selling price of a range of items, overriding the one based on the vendor price
+//
+
+struct AHBPriceOverride
+{
+    uint32 itemStart;
+    uint32 itemEnd;
+    uint32 minBuyout;
+    uint32 maxBuyout;
+    uint32 minBidRatio;
+    uint32 maxBidRatio;
+};
+
+//
+// What the buyer is willing to pay for one unit of an item, by item template
+//
+
+struct AHBBuyerValuation
+{
+    uint64 maxUnitBid = 0;
+    bool   excluded   = true;
+};
+
+//
+// Row of mod_auctionhousebot for one auction house, keyed by column name
+//
+
+typedef std::unordered_map<std::string, uint32> AHBSettings;
+
+//
+// One of the configured tests excluding an item template from the catalog
+//
+
+struct AHBItemFilter
+{
+    std::string                              name;
+    std::function<bool(ItemTemplate const*)> rejects;
+};
+
 class AHBConfig
 {
 private:
@@ -103,6 +186,12 @@ private:
     uint32 buyerBiddingInterval;
     uint32 buyerBidsPerInterval;
 
+    //
+    // Buyer valuations indexed by item template, rebuilt when the buyer prices change
+    //
+
+    std::vector<AHBBuyerValuation> buyerValuations;
+
     //
     // Amount of items to be sold in absolute values
     //
@@ -151,8 +240,57 @@ private:
     std::map<uint32, uint64> itemsSum;
     std::map<uint32, uint64> itemsPrice;
 
+    //
+    // Live auctions of the bots, keyed by (bot id, item template)
+    //
+
+    std::unordered_map<uint64, uint32> botListings;
+
+    //
+    // Live auctions of every bot and of all the bots together, so that the quotas need no scan
+    //
+
+    std::unordered_map<uint32, uint32> botAuctions;
+    uint32                             botAuctionsTotal;
+
+    //
+    // Auctions of the players, the ones the buyer can bid on
+    //
+
+    AHBCandidateSet buyCandidates;
+
+    //
+    // Buyer candidates by discount, for the best deal strategy. The prices change without notice (the bids),
+    // so the entries are checked when they reach the top and pushed back if their discount went down.
+    //
+
+    std::priority_queue<AHBDeal> bestDeals;
+
+    bool   GetDiscount       (AuctionEntry const* auction, double& discount);
+
+    //
+    // Buyer candidates by expiration time, for the expiring first strategy
+    //
+
+    AHBExpiryWheel expiringAuctions;
+
+    //
+    // Filters used to build the catalog, to share it between houses with the same settings
+    //
+
+    std::string catalogSignature;
+
     void   InitializeFromFile();
-    void   InitializeFromSql(std::set<uint32> botsIds);
+    void   InitializeFromSql(AHBSettings const& settings);
+    void   InitializeItemSources();
+    void   BuildCatalog();
+
+    std::vector<AHBItemFilter> CompileFilters() const;
+    void   SortFilters(std::vector<AHBItemFilter>& filters, std::vector<ItemTemplate const*> const& templates) const;
+
+    std::string GetCatalogSignature();
+
+    uint32 GetSetting(AHBSettings const& settings, std::string const& column);
 
     std::set<uint32> getCommaSeparatedIntegers(std::string text);
 
@@ -186,6 +324,14 @@ public:
     uint32 MarketResetThreshold;
     bool   ConsiderOnlyBotAuctions;
     uint32 ItemsPerCycle;
+    uint32 InitializationThreads;
+    uint32 SellBudgetMicroseconds;
+    uint32 SellInterval;
+    bool   SellerOwnership;
+    uint32 ListingsPerTransaction;
+    uint32 BuyerStrategy;
+    uint32 BuyerExpiringWindow;
+    uint32 BuyerCandidateSource;
 
     //
     // Filters
@@ -265,28 +411,16 @@ public:
     std::set<uint32> SellerWhiteList;
 
     //
-    // Bins for trade goods.
+    // Selling prices overrides, as disjoint ranges sorted by their first item
     //
 
-    std::set<uint32> GreyTradeGoodsBin;
-    std::set<uint32> WhiteTradeGoodsBin;
-    std::set<uint32> GreenTradeGoodsBin;
-    std::set<uint32> BlueTradeGoodsBin;
-    std::set<uint32> PurpleTradeGoodsBin;
-    std::set<uint32> OrangeTradeGoodsBin;
-    std::set<uint32> YellowTradeGoodsBin;
+    std::vector<AHBPriceOverride> PriceOverrides;
 
     //
-    // Bins for items
+    // Bins for trade goods and items
     //
 
-    std::set<uint32> GreyItemsBin;
-    std::set<uint32> WhiteItemsBin;
-    std::set<uint32> GreenItemsBin;
-    std::set<uint32> BlueItemsBin;
-    std::set<uint32> PurpleItemsBin;
-    std::set<uint32> OrangeItemsBin;
-    std::set<uint32> YellowItemsBin;
+    std::shared_ptr<AHBCatalog const> Catalog;
 
     //
     // Constructors/destructors
@@ -301,10 +435,15 @@ public:
     // Ruotines
     //
 
-    void   Initialize(std::set<uint32> botsIds);
-    void   InitializeBins();
+    void   Initialize(std::set<uint32> botsIds, AHBSettings const& settings, AHBConfig const* shared = nullptr);
+    void   InitializeSettings(AHBSettings const& settings, AHBConfig const* shared = nullptr);
+    void   InitializeAuctions(std::set<uint32> botsIds);
+    void   InitializeBins(AHBConfig const* shared = nullptr);
+    void   InitializeBuyerValuations();
     void   Reset();
 
+    static std::map<uint32, AHBSettings> LoadSettings();
+
     uint32 GetAHID();
     uint32 GetAHFID();
 
@@ -336,6 +475,8 @@ public:
     void   SetBuyerPrice     (uint32 color, uint32 value);
     uint32 GetBuyerPrice     (uint32 color);
 
+    AHBBuyerValuation const& GetBuyerValuation(uint32 itemId);
+
     void   SetBiddingInterval(uint32 value);
     uint32 GetBiddingInterval();
 
@@ -356,8 +497,27 @@ public:
 
     uint32 GetItemCounts     (uint32 color);
 
+    void   IncBotListings    (uint32 botId, uint32 itemId);
+    void   DecBotListings    (uint32 botId, uint32 itemId);
+    uint32 GetBotListings    (uint32 botId, uint32 itemId);
+    uint32 GetBotAuctions    (uint32 botId);
+    uint32 GetBotAuctions    ();
+    void   ResetBotListings  ();
+
+    void   AddBuyCandidate   (AuctionEntry const* auction);
+    void   RemoveBuyCandidate(uint32 auctionId);
+    void   ResetBuyCandidates();
+    void   RebuildBestDeals  ();
+    void   DrawBestDeals     (uint32 count, uint32 botId, std::vector<uint32>& drawn);
+    void   DrawExpiring      (uint32 count, uint32 botId, std::vector<uint32>& drawn);
+
+    AHBCandidateSet& GetBuyCandidates() { return buyCandidates; }
+
     void   UpdateItemStats   (uint32 id, uint32 stackSize, uint64 buyout);
     uint64 GetItemPrice      (uint32 id);
+    void   TakeItemStats     (AHBConfig* other);
+
+    AHBPriceOverride const* GetPriceOverride(uint32 itemId) const;
 };
 
 //
@@ -368,4 +528,27 @@ extern AHBConfig* gAllianceConfig;
 extern AHBConfig* gHordeConfig;
 extern AHBConfig* gNeutralConfig;
 
+//
+// Bots and configurations built in the background after a reload, waiting to replace the ones in use
+//
+
+struct AHBConfigSet
+{
+    uint32           generation = 0;
+    std::set<uint32> botsIds;
+
+    AHBConfig* allianceConfig = nullptr;
+    AHBConfig* hordeConfig    = nullptr;
+    AHBConfig* neutralConfig  = nullptr;
+
+    ~AHBConfigSet()
+    {
+        delete allianceConfig;
+        delete hordeConfig;
+        delete neutralConfig;
+    }
+};
+
+extern std::atomic<AHBConfigSet*> gPendingConfigs;
+
 #endif // AUCTION_HOUSE_BOT_CONFIG_H
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include "Item.h"
+#include "Random.h"
+
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotPlanner.h"
+
+AHBPlanner gPlanner;
+
+AHBPlanner::AHBPlanner() : generation(0), running(false)
+{
+    for (uint32 house = 0; house < AHB_PLANNER_HOUSES; ++house)
+    {
+        configs[house]  = nullptr;
+        settings[house] = nullptr;
+    }
+}
+
+AHBPlanner::~AHBPlanner()
+{
+    Stop();
+}
+
+void AHBPlanner::Start(AHBConfig* allianceConfig, AHBConfig* hordeConfig, AHBConfig* neutralConfig)
+{
+    Stop();
+
+    configs[0] = allianceConfig;
+    configs[1] = hordeConfig;
+    configs[2] = neutralConfig;
+
+    //
+    // Plans made for a previous configuration are thrown away, and so are the settings copied for it
+    //
+
+    for (uint32 house = 0; house < AHB_PLANNER_HOUSES; ++house)
+    {
+        settings[house] = nullptr;
+    }
+
+    published.clear();
+
+    for (uint32 house = 0; house < AHB_PLANNER_HOUSES; ++house)
+    {
+        if (configs[house])
+        {
+            Publish(house);
+        }
+
+        for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+        {
+            queues[house][category].Clear();
+        }
+    }
+
+    running = true;
+    worker  = std::thread(&AHBPlanner::Run, this);
+}
+
+void AHBPlanner::Stop()
+{
+    running = false;
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void AHBPlanner::Refresh()
+{
+    //
+    // Called on the world thread after a command changed the prices, the stacks or the seller state. The worker
+    // goes on with the new settings from its next plan; the plans already queued are dropped when popped.
+    //
+
+    if (!running)
+    {
+        return;
+    }
+
+    for (uint32 house = 0; house < AHB_PLANNER_HOUSES; ++house)
+    {
+        if (configs[house])
+        {
+            Publish(house);
+        }
+    }
+}
+
+void AHBPlanner::Publish(uint32 house)
+{
+    std::unique_ptr<AHBPlanSettings> copy = std::make_unique<AHBPlanSettings>();
+
+    copy->Load(configs[house]);
+    copy->generation = ++generation;
+
+    settings[house].store(copy.get(), std::memory_order_release);
+    published.push_back(std::move(copy));
+}
+
+bool AHBPlanner::Pop(uint32 ahID, uint32 category, AHBListingPlan& plan)
+{
+    if (!running || category >= AHB_CATEGORIES)
+    {
+        return false;
+    }
+
+    uint32                 house   = GetHouse(ahID);
+    AHBPlanSettings const* current = settings[house].load(std::memory_order_acquire);
+
+    //
+    // Skip the plans made before the settings changed
+    //
+
+    while (queues[house][category].Pop(plan))
+    {
+        if (current && plan.generation == current->generation)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AHBPlanner::Run()
+{
+    //
+    // Keep every queue full, from the latest settings published by the world thread
+    //
+
+    while (running)
+    {
+        bool planned = false;
+
+        for (uint32 house = 0; house < AHB_PLANNER_HOUSES && running; ++house)
+        {
+            AHBPlanSettings const* current = settings[house].load(std::memory_order_acquire);
+
+            if (!configs[house] || !current || !current->seller)
+            {
+                continue;
+            }
+
+            for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+            {
+                AHBListingPlan plan;
+
+                while (!queues[house][category].IsFull() && MakePlan(*current, category, plan))
+                {
+                    queues[house][category].Push(plan);
+                    planned = true;
+                }
+            }
+        }
+
+        if (!planned)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(AHB_PLANNER_IDLE_MS));
+        }
+    }
+}
+
+void AHBPlanSettings::Load(AHBConfig* config)
+{
+    catalog           = config->Catalog;
+    generation        = 0;
+    seller            = config->AHBSeller;
+    divisibleStacks   = config->DivisibleStacks;
+    elapsingTimeClass = config->ElapsingTimeClass;
+
+    for (uint32 quality = 0; quality <= AHB_MAX_QUALITY; ++quality)
+    {
+        minPrice[quality]    = config->GetMinPrice(quality);
+        maxPrice[quality]    = config->GetMaxPrice(quality);
+        minBidPrice[quality] = config->GetMinBidPrice(quality);
+        maxBidPrice[quality] = config->GetMaxBidPrice(quality);
+        maxStack[quality]    = config->GetMaxStack(quality);
+    }
+}
+
+bool AHBPlanner::MakePlan(AHBPlanSettings const& settings, uint32 category, AHBListingPlan& plan)
+{
+    uint32 row = settings.catalog->GetRandomRow(category);
+
+    if (row == AHB_CATALOG_NO_ROW)
+    {
+        return false;
+    }
+
+    uint32 quality = settings.catalog->GetQuality(row);
+
+    plan.row              = row;
+    plan.randomPropertyId = 0;
+    plan.generation       = settings.generation;
+
+    // 
+    // Random property
+    // 
+
+    if (settings.catalog->HasRandomProperty(row))
+    {
+        plan.randomPropertyId = Item::GenerateItemRandomPropertyId(settings.catalog->GetItemId(row));
+    }
+
+    // 
+    // Price
+    // 
+
+    plan.priceRatio = urand(settings.minPrice[quality], settings.maxPrice[quality]);
+    plan.bidRatio   = urand(settings.minBidPrice[quality], settings.maxBidPrice[quality]);
+
+    // 
+    // Stack size
+    // 
+
+    uint32 maxStack     = settings.maxStack[quality];
+    uint32 itemMaxStack = settings.catalog->GetMaxStack(row);
+
+    if (maxStack > 1 && itemMaxStack > 1)
+    {
+        plan.stackCount = std::min(GetStackCount(settings.divisibleStacks, itemMaxStack), maxStack);
+    }
+    else if (maxStack == 0 && itemMaxStack > 1)
+    {
+        plan.stackCount = GetStackCount(settings.divisibleStacks, itemMaxStack);
+    }
+    else
+    {
+        plan.stackCount = 1;
+    }
+
+    // 
+    // Auction time
+    // 
+
+    plan.duration = GetElapsedTime(settings.elapsingTimeClass);
+
+    return true;
+}
+
+uint32 AHBPlanner::GetHouse(uint32 ahID)
+{
+    switch (ahID)
+    {
+    case 2:
+        return 0;
+    case 6:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+uint32 AHBPlanner::GetStackCount(bool divisible, uint32 max)
+{
+    if (max == 1)
+    {
+        return 1;
+    }
+
+    // 
+    // Organize the stacks in a pseudo random way
+    // 
+
+    if (divisible)
+    {
+        uint32 ret = 0;
+
+        if (max % 5 == 0) // 5, 10, 15, 20
+        {
+            ret = urand(1, 4) * 5;
+        }
+
+        if (max % 4 == 0) // 4, 8, 12, 16
+        {
+            ret = urand(1, 4) * 4;
+        }
+
+        if (max % 3 == 0) // 3, 6, 9, 18
+        {
+            ret = urand(1, 3) * 3;
+        }
+
+        if (ret > max)
+        {
+            ret = max;
+        }
+
+        return ret;
+    }
+
+    // 
+    // Totally random
+    // 
+
+    return urand(1, max);
+}
+
+uint32 AHBPlanner::GetElapsedTime(uint32 timeClass)
+{
+    switch (timeClass)
+    {
+    case 2:
+        return urand(1, 5) * 600;   // SHORT = In the range of one hour
+
+    case 1:
+        return urand(1, 23) * 3600; // MEDIUM = In the range of one day
+
+    default:
+        return urand(1, 3) * 86400; // LONG = More than one day but less than three
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_PLANNER_H
+#define AUCTION_HOUSE_BOT_PLANNER_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Common.h"
+#include "ItemTemplate.h"
+
+#include "AuctionHouseBotCommon.h"
+
+class AHBCatalog;
+class AHBConfig;
+
+//
+// Plans kept ready for every house and category, and pause of the planner when they are all full
+//
+
+#define AHB_PLANNER_QUEUE_SIZE 64
+#define AHB_PLANNER_IDLE_MS    100
+#define AHB_PLANNER_HOUSES     3
+
+//
+// Everything about a new auction that can be decided away from the world thread. The prices are percentages,
+// applied to the base price of the item when the auction is created.
+//
+
+struct AHBListingPlan
+{
+    uint32 row;                // Catalog row of the item
+    uint32 randomPropertyId;
+    uint32 priceRatio;         // Buyout, in percent of the base price
+    uint32 bidRatio;           // Starting bid, in percent of the buyout
+    uint32 stackCount;
+    uint32 duration;           // Seconds
+    uint32 generation;         // Of the settings it was made from
+};
+
+//
+// The part of a configuration used to make the plans, copied on the world thread so that the planner never
+// reads the fields changed by the commands. A command changing them publishes a new copy, with a new generation.
+//
+
+struct AHBPlanSettings
+{
+    std::shared_ptr<AHBCatalog const> catalog;
+
+    uint32 generation;
+
+    bool   seller;
+    bool   divisibleStacks;
+    uint32 elapsingTimeClass;
+
+    uint32 minPrice   [AHB_MAX_QUALITY + 1];
+    uint32 maxPrice   [AHB_MAX_QUALITY + 1];
+    uint32 minBidPrice[AHB_MAX_QUALITY + 1];
+    uint32 maxBidPrice[AHB_MAX_QUALITY + 1];
+    uint32 maxStack   [AHB_MAX_QUALITY + 1];
+
+    void Load(AHBConfig* config);
+};
+
+// =============================================================================
+// Fixed size queue with one producer and one consumer, without locks
+// =============================================================================
+
+template <class T, uint32 N>
+class AHBRing
+{
+private:
+    T                   items[N];
+    std::atomic<uint32> head;
+    std::atomic<uint32> tail;
+
+public:
+    AHBRing() : head(0), tail(0) { }
+
+    bool IsFull() const
+    {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) >= N;
+    }
+
+    bool Push(T const& item)
+    {
+        uint32 t = tail.load(std::memory_order_relaxed);
+
+        if (t - head.load(std::memory_order_acquire) >= N)
+        {
+            return false;
+        }
+
+        items[t % N] = item;
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool Pop(T& item)
+    {
+        uint32 h = head.load(std::memory_order_relaxed);
+
+        if (h == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = items[h % N];
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    //
+    // Only while neither side is running
+    //
+
+    void Clear()
+    {
+        head.store(0);
+        tail.store(0);
+    }
+};
+
+// =============================================================================
+// Prepares the listings of the sellers on its own thread, so that the world
+// thread only has to create the items and save the auctions.
+// =============================================================================
+
+class AHBPlanner
+{
+private:
+    AHBConfig*        configs[AHB_PLANNER_HOUSES];
+    AHBRing<AHBListingPlan, AHB_PLANNER_QUEUE_SIZE> queues[AHB_PLANNER_HOUSES][AHB_CATEGORIES];
+
+    //
+    // Settings in use, read by the worker. The copies published since the start are all kept until the next one,
+    // so that the worker never reads one that was freed.
+    //
+
+    std::atomic<AHBPlanSettings const*>           settings[AHB_PLANNER_HOUSES];
+    std::vector<std::unique_ptr<AHBPlanSettings>> published;
+    uint32                                        generation;
+
+    std::thread       worker;
+    std::atomic<bool> running;
+
+    void   Run();
+    void   Publish(uint32 house);
+
+    static uint32 GetHouse(uint32 ahID);
+    static uint32 GetStackCount(bool divisible, uint32 max);
+    static uint32 GetElapsedTime(uint32 timeClass);
+
+public:
+    AHBPlanner();
+    ~AHBPlanner();
+
+    void   Start(AHBConfig* allianceConfig, AHBConfig* hordeConfig, AHBConfig* neutralConfig);
+    void   Stop();
+    void   Refresh();
+
+    bool   Pop(uint32 ahID, uint32 category, AHBListingPlan& plan);
+
+    static bool MakePlan(AHBPlanSettings const& settings, uint32 category, AHBListingPlan& plan);
+};
+
+extern AHBPlanner gPlanner;
+
+#endif // AUCTION_HOUSE_BOT_PLANNER_H
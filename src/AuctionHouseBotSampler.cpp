@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include "Random.h"
+
+#include "AuctionHouseBotSampler.h"
+
+AHBCategorySampler::AHBCategorySampler()
+{
+    for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+    {
+        weights[category]     = 0;
+        probability[category] = 0.0;
+        alias[category]       = category;
+    }
+
+    totalWeight = 0;
+}
+
+AHBCategorySampler::~AHBCategorySampler()
+{
+
+}
+
+void AHBCategorySampler::SetWeights(uint32 const* values)
+{
+    for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+    {
+        weights[category] = values[category];
+    }
+
+    Rebuild();
+}
+
+void AHBCategorySampler::SetWeight(uint32 category, uint32 value)
+{
+    if (category >= AHB_CATEGORIES || weights[category] == value)
+    {
+        return;
+    }
+
+    weights[category] = value;
+
+    Rebuild();
+}
+
+uint32 AHBCategorySampler::GetWeight(uint32 category) const
+{
+    if (category >= AHB_CATEGORIES)
+    {
+        return 0;
+    }
+
+    return weights[category];
+}
+
+bool AHBCategorySampler::IsEmpty() const
+{
+    return totalWeight == 0;
+}
+
+uint32 AHBCategorySampler::Sample() const
+{
+    if (totalWeight == 0)
+    {
+        return AHB_CATEGORIES;
+    }
+
+    uint32 column = urand(0, AHB_CATEGORIES - 1);
+
+    if (rand_norm() < probability[column])
+    {
+        return column;
+    }
+
+    return alias[column];
+}
+
+void AHBCategorySampler::Rebuild()
+{
+    //
+    // Vose's alias method: every column holds its own share plus, if short, a part of a larger category.
+    // The table is as large as the number of categories, so rebuilding it after every listing is cheap.
+    //
+
+    totalWeight = 0;
+
+    uint32 fallback = AHB_CATEGORIES;
+
+    for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+    {
+        totalWeight += weights[category];
+
+        if (weights[category] > 0 && fallback == AHB_CATEGORIES)
+        {
+            fallback = category;
+        }
+    }
+
+    if (totalWeight == 0)
+    {
+        return;
+    }
+
+    double scaled[AHB_CATEGORIES];
+    uint32 small[AHB_CATEGORIES];
+    uint32 large[AHB_CATEGORIES];
+    uint32 smallCount = 0;
+    uint32 largeCount = 0;
+
+    for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+    {
+        scaled[category] = double(weights[category]) * AHB_CATEGORIES / double(totalWeight);
+
+        if (scaled[category] < 1.0)
+        {
+            small[smallCount++] = category;
+        }
+        else
+        {
+            large[largeCount++] = category;
+        }
+    }
+
+    while (smallCount > 0 && largeCount > 0)
+    {
+        uint32 less = small[--smallCount];
+        uint32 more = large[--largeCount];
+
+        probability[less] = scaled[less];
+        alias[less]       = more;
+
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+
+        if (scaled[more] < 1.0)
+        {
+            small[smallCount++] = more;
+        }
+        else
+        {
+            large[largeCount++] = more;
+        }
+    }
+
+    while (largeCount > 0)
+    {
+        uint32 more = large[--largeCount];
+
+        probability[more] = 1.0;
+        alias[more]       = more;
+    }
+
+    //
+    // Whatever is left is due to rounding errors; never let it point to an empty category
+    //
+
+    while (smallCount > 0)
+    {
+        uint32 less = small[--smallCount];
+
+        probability[less] = weights[less] > 0 ? 1.0 : 0.0;
+        alias[less]       = weights[less] > 0 ? less : fallback;
+    }
+}
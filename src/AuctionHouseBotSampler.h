@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_SAMPLER_H
+#define AUCTION_HOUSE_BOT_SAMPLER_H
+
+#include "Common.h"
+
+#include "AuctionHouseBotCommon.h"
+
+// =============================================================================
+// Weighted random choice among the item categories (alias method). The weight
+// of a category is how many items it still misses; categories with a zero
+// weight are never returned.
+// =============================================================================
+
+class AHBCategorySampler
+{
+private:
+    uint32 weights[AHB_CATEGORIES];
+    double probability[AHB_CATEGORIES];
+    uint32 alias[AHB_CATEGORIES];
+    uint64 totalWeight;
+
+    void   Rebuild();
+
+public:
+    AHBCategorySampler();
+    ~AHBCategorySampler();
+
+    void   SetWeights(uint32 const* values);
+    void   SetWeight (uint32 category, uint32 value);
+    uint32 GetWeight (uint32 category) const;
+
+    bool   IsEmpty() const;
+    uint32 Sample() const;
+};
+
+#endif // AUCTION_HOUSE_BOT_SAMPLER_H
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#include <algorithm>
+
+#include "Random.h"
+
+#include "AuctionHouseBot.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseBotScheduler.h"
+
+AHBScheduler gScheduler;
+
+AHBScheduler::AHBScheduler()
+{
+
+}
+
+AHBScheduler::~AHBScheduler()
+{
+
+}
+
+void AHBScheduler::Start(std::set<AuctionHouseBot*> const& bots)
+{
+    Clear();
+
+    //
+    // Take turns in the order of the characters, not of the allocations
+    //
+
+    owners.assign(bots.begin(), bots.end());
+
+    std::sort(owners.begin(), owners.end(), [](AuctionHouseBot* a, AuctionHouseBot* b)
+    {
+        return a->GetAHBplayerGUID() < b->GetAHBplayerGUID();
+    });
+
+    if (owners.empty())
+    {
+        return;
+    }
+
+    //
+    // The first runs are spread over a whole interval, so that the bots do not all start on the same update
+    //
+
+    uint32 const houses[] = { 2, 6, 7 };
+
+    for (uint32 ahID : houses)
+    {
+        AHBConfig* config = owners.front()->GetConfig(ahID);
+
+        if (!config || !owners.front()->IsHouseActive(ahID))
+        {
+            continue;
+        }
+
+        for (AHBOperation operation : { AHB_OPERATION_SELL, AHB_OPERATION_BUY })
+        {
+            std::chrono::milliseconds interval = GetInterval(config, operation);
+
+            if (config->SellerOwnership)
+            {
+                uint32                            turn     = urand(0, uint32(owners.size()) - 1);
+                std::shared_ptr<AHBBuyerPrefetch> prefetch = operation == AHB_OPERATION_BUY ? std::make_shared<AHBBuyerPrefetch>() : nullptr;
+
+                if (prefetch)
+                {
+                    Prefetch(owners[turn], config, prefetch);
+                }
+
+                Schedule({ std::chrono::steady_clock::time_point(), nullptr, ahID, operation, turn, prefetch }, std::chrono::milliseconds(urand(0, uint32(interval.count()))));
+                continue;
+            }
+
+            for (AuctionHouseBot* bot : owners)
+            {
+                std::shared_ptr<AHBBuyerPrefetch> prefetch = operation == AHB_OPERATION_BUY ? std::make_shared<AHBBuyerPrefetch>() : nullptr;
+
+                if (prefetch)
+                {
+                    Prefetch(bot, config, prefetch);
+                }
+
+                Schedule({ std::chrono::steady_clock::time_point(), bot, ahID, operation, 0, prefetch }, std::chrono::milliseconds(urand(0, uint32(interval.count()))));
+            }
+        }
+    }
+}
+
+void AHBScheduler::Clear()
+{
+    tasks = std::priority_queue<AHBTask, std::vector<AHBTask>, Later>();
+    owners.clear();
+}
+
+void AHBScheduler::Update()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    while (!tasks.empty() && tasks.top().due <= now)
+    {
+        AHBTask task = tasks.top();
+        tasks.pop();
+
+        //
+        // A shared task goes to the next bot in turn
+        //
+
+        AuctionHouseBot* bot = task.bot;
+
+        if (!bot)
+        {
+            bot = owners[task.turn % owners.size()];
+            task.turn++;
+        }
+
+        bot->Run(task.ahID, task.operation, task.prefetch);
+
+        //
+        // The configuration is read again, the intervals can be changed with the commands
+        //
+
+        AHBConfig* config = bot->GetConfig(task.ahID);
+
+        if (config)
+        {
+            Schedule(task, AddJitter(GetInterval(config, task.operation)));
+        }
+    }
+}
+
+void AHBScheduler::Prefetch(AuctionHouseBot* bot, AHBConfig* config, std::shared_ptr<AHBBuyerPrefetch> const& prefetch)
+{
+    //
+    // The buyer reading its candidates from the database bids on the result of the previous query; ask for the
+    // first one now, it is usually back before the first interval
+    //
+
+    if (config->AHBBuyer && config->BuyerCandidateSource == AHB_CANDIDATES_DATABASE)
+    {
+        bot->PrefetchBuyCandidates(config, prefetch);
+    }
+}
+
+uint32 AHBScheduler::GetCount() const
+{
+    return uint32(tasks.size());
+}
+
+void AHBScheduler::Schedule(AHBTask task, std::chrono::milliseconds delay)
+{
+    task.due = std::chrono::steady_clock::now() + delay;
+
+    tasks.push(task);
+}
+
+std::chrono::milliseconds AHBScheduler::GetInterval(AHBConfig* config, AHBOperation operation)
+{
+    std::chrono::milliseconds sellInterval = std::chrono::seconds(std::max<uint32>(1, config->SellInterval));
+
+    if (operation == AHB_OPERATION_SELL)
+    {
+        return sellInterval;
+    }
+
+    //
+    // Bidding never happens more often than selling, as when both followed the auction house updates
+    //
+
+    return std::max<std::chrono::milliseconds>(sellInterval, std::chrono::minutes(config->GetBiddingInterval()));
+}
+
+std::chrono::milliseconds AHBScheduler::AddJitter(std::chrono::milliseconds interval)
+{
+    int32 range = int32(interval.count() * AHB_SCHEDULER_JITTER / 100);
+
+    return interval + std::chrono::milliseconds(irand(-range, range));
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
+ */
+
+#ifndef AUCTION_HOUSE_BOT_SCHEDULER_H
+#define AUCTION_HOUSE_BOT_SCHEDULER_H
+
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "Common.h"
+
+class AuctionHouseBot;
+class AHBConfig;
+
+//
+// Maximum deviation of the run intervals, in percent, so that the bots drift apart
+//
+
+#define AHB_SCHEDULER_JITTER 10
+
+enum AHBOperation
+{
+    AHB_OPERATION_SELL,
+    AHB_OPERATION_BUY
+};
+
+//
+// Buyer candidates read from the database, fetched one interval ahead so that the bids never wait for the query.
+// Kept by the buy task, so that the bot running it uses the result of the previous interval, whoever asked for it.
+//
+
+struct AHBBuyerPrefetch
+{
+    std::vector<uint32> auctions;
+    bool                pending = false;
+};
+
+struct AHBTask
+{
+    std::chrono::steady_clock::time_point due;
+
+    AuctionHouseBot* bot;       // nullptr when the bots take turns
+    uint32           ahID;
+    AHBOperation     operation;
+    uint32           turn;
+
+    std::shared_ptr<AHBBuyerPrefetch> prefetch; // Buy tasks only
+};
+
+// =============================================================================
+// Runs the operations of the bots on the auction houses. Every (bot, house,
+// operation) has its own next run time; the world update only runs the tasks
+// that are due, the earliest first. With the seller ownership every (house,
+// operation) has a single task instead, run by the bots in turn.
+// =============================================================================
+
+class AHBScheduler
+{
+private:
+    struct Later
+    {
+        bool operator()(AHBTask const& a, AHBTask const& b) const { return a.due > b.due; }
+    };
+
+    std::priority_queue<AHBTask, std::vector<AHBTask>, Later> tasks;
+    std::vector<AuctionHouseBot*>                             owners;
+
+    void Schedule(AHBTask task, std::chrono::milliseconds delay);
+
+    static void Prefetch(AuctionHouseBot* bot, AHBConfig* config, std::shared_ptr<AHBBuyerPrefetch> const& prefetch);
+
+    static std::chrono::milliseconds GetInterval(AHBConfig* config, AHBOperation operation);
+    static std::chrono::milliseconds AddJitter  (std::chrono::milliseconds interval);
+
+public:
+    AHBScheduler();
+    ~AHBScheduler();
+
+    void   Start(std::set<AuctionHouseBot*> const& bots);
+    void   Clear();
+    void   Update();
+
+    uint32 GetCount() const;
+};
+
+extern AHBScheduler gScheduler;
+
+#endif // AUCTION_HOUSE_BOT_SCHEDULER_H
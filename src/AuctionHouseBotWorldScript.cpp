@@ -2,23 +2,69 @@
  * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license: https://github.com/azerothcore/azerothcore-wotlk/blob/master/LICENSE
  */
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <utility>
+
 #include "Config.h"
 #include "Log.h"
 
 #include "AuctionHouseBot.h"
 #include "AuctionHouseBotCommon.h"
+#include "AuctionHouseBotPlanner.h"
 #include "AuctionHouseBotWorldScript.h"
 
 // =============================================================================
 // Initialization of the bot during the world startup
 // =============================================================================
 
+std::atomic<uint32> AHBot_WorldScript::reloadGeneration(0);
+
 AHBot_WorldScript::AHBot_WorldScript() : WorldScript("AHBot_WorldScript")
 {
 
 }
 
 void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
+{
+    bool debug = sConfigMgr->GetOption<bool>("AuctionHouseBot.DEBUG", false);
+
+    // 
+    // Start the bots only if the operation is a reload, otherwise let the OnStartup do the job
+    // 
+
+    if (!reload)
+    {
+        LoadBotsIds(gBotsId);
+        return;
+    }
+
+    if (debug)
+    {
+        LOG_INFO("module", "AHBot: Reloading the bots");
+    }
+
+    //
+    // Build the new configuration in the background while the current bots keep running; it is swapped in
+    // by the world thread on its next update. A reload still being built is not waited for: it becomes stale
+    // and is dropped as soon as it notices.
+    //
+
+    reloads.erase(std::remove_if(reloads.begin(), reloads.end(), [](std::future<void> const& reload)
+    {
+        return reload.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), reloads.end());
+
+    reloads.push_back(std::async(std::launch::async, &AHBot_WorldScript::BuildConfigs, ++reloadGeneration));
+}
+
+bool AHBot_WorldScript::IsStale(uint32 generation)
+{
+    return generation != reloadGeneration.load();
+}
+
+bool AHBot_WorldScript::LoadBotsIds(std::set<uint32>& botsIds)
 {
     //
     // Retrieve how many bots shall be operating on the auction market
@@ -36,7 +82,7 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
     if (account == 0 && player == 0)
     {
         LOG_ERROR("server.loading", "AHBot: Account id and player id missing from configuration; is that the right file?");
-        return;
+        return false;
     }
     else
     {
@@ -44,7 +90,7 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
 
         if (result)
         {
-            gBotsId.clear();
+            botsIds.clear();
 
             do
             {
@@ -58,7 +104,7 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
                         LOG_INFO("server.loading", "AHBot: New bot to start, account={} character={}", account, botId);
                     }
 
-                    gBotsId.insert(botId);
+                    botsIds.insert(botId);
                 }
                 else
                 {
@@ -69,7 +115,7 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
                             LOG_INFO("server.loading", "AHBot: Starting only one bot, account={} character={}", account, botId);
                         }
 
-                        gBotsId.insert(botId);
+                        botsIds.insert(botId);
                         break;
                     }
                 }
@@ -79,66 +125,186 @@ void AHBot_WorldScript::OnBeforeConfigLoad(bool reload)
         else
         {
             LOG_ERROR("server.loading", "AHBot: Could not query the database for characters of account {}", account);
-            return;
+            return false;
         }
     }
 
-    if (gBotsId.size() == 0)
+    if (botsIds.size() == 0)
     {
         LOG_ERROR("server.loading", "AHBot: no characters registered for account {}", account);
+        return false;
+    }
+
+    return true;
+}
+
+void AHBot_WorldScript::BuildConfigs(uint32 generation)
+{
+    //
+    // Runs on the reload thread: only the database and the item templates are read here, never the auction houses
+    //
+
+    AHBConfigSet* configs = new AHBConfigSet();
+
+    configs->generation = generation;
+
+    if (!LoadBotsIds(configs->botsIds) || IsStale(generation))
+    {
+        delete configs;
         return;
     }
 
-    // 
-    // Start the bots only if the operation is a reload, otherwise let the OnStartup do the job
-    // 
+    std::map<uint32, AHBSettings> settings = AHBConfig::LoadSettings();
+
+    configs->allianceConfig = new AHBConfig(2);
+    configs->hordeConfig    = new AHBConfig(6);
+    configs->neutralConfig  = new AHBConfig(7);
 
-    if (reload)
+    configs->allianceConfig->InitializeSettings(settings[configs->allianceConfig->GetAHID()]);
+    configs->hordeConfig->InitializeSettings   (settings[configs->hordeConfig->GetAHID()]   , configs->allianceConfig);
+    configs->neutralConfig->InitializeSettings (settings[configs->neutralConfig->GetAHID()] , configs->allianceConfig);
+
+    //
+    // Publish the new set, unless a newer reload started meanwhile; an older set never picked up is replaced
+    //
+
+    AHBConfigSet* pending = gPendingConfigs.load();
+
+    do
     {
-        if (debug)
+        if (IsStale(generation) || (pending && pending->generation > generation))
         {
-            LOG_INFO("module", "AHBot: Reloading the bots");
+            delete configs;
+            return;
         }
+    } while (!gPendingConfigs.compare_exchange_weak(pending, configs));
 
-        //
-        // Clear the bots array; this way they wont be used anymore during the initialization stage.
-        //
+    delete pending;
+}
 
-        DeleteBots();
+void AHBot_WorldScript::OnStartup()
+{
+    LOG_INFO("server.loading", "Initialize AuctionHouseBot...");
 
-        //
-        // Reload the configuration for the auction houses
-        //
+    //
+    // Initialize the configuration (done only once at startup); the item catalog is built once and shared
+    // between the houses whose filters are the same
+    //
 
-        gAllianceConfig->Initialize(gBotsId);
-        gHordeConfig->Initialize   (gBotsId);
-        gNeutralConfig->Initialize (gBotsId);
+    std::map<uint32, AHBSettings> settings = AHBConfig::LoadSettings();
 
-        //
-        // Start again the bots
-        //
+    gAllianceConfig->Initialize(gBotsId, settings[gAllianceConfig->GetAHID()]);
+    gHordeConfig->Initialize   (gBotsId, settings[gHordeConfig->GetAHID()]  , gAllianceConfig);
+    gNeutralConfig->Initialize (gBotsId, settings[gNeutralConfig->GetAHID()], gAllianceConfig);
 
-        PopulateBots();
+    //
+    // Starts the bots, and the planner preparing their listings
+    //
+
+    PopulateBots();
+
+    gPlanner.Start(gAllianceConfig, gHordeConfig, gNeutralConfig);
+}
+
+void AHBot_WorldScript::OnUpdate(uint32 /*diff*/)
+{
+    //
+    // Swap in a configuration built in the background, between two world updates
+    //
+
+    if (gPendingConfigs.load(std::memory_order_relaxed) != nullptr)
+    {
+        AHBConfigSet* configs = gPendingConfigs.exchange(nullptr);
+
+        if (configs && IsStale(configs->generation))
+        {
+            delete configs;
+        }
+        else if (configs)
+        {
+            SwapConfigs(configs);
+        }
+    }
+
+    //
+    // Run the operations that are due, then let the sellers go on with the listings left over by the previous update
+    //
+
+    gScheduler.Update();
+
+    for (AuctionHouseBot* bot: gBots)
+    {
+        bot->ProcessQueryCallbacks();
+        bot->ResumeSell();
     }
 }
 
-void AHBot_WorldScript::OnStartup()
+void AHBot_WorldScript::OnShutdown()
 {
-    LOG_INFO("server.loading", "Initialize AuctionHouseBot...");
+    gPlanner.Stop();
+
+    //
+    // Make every reload still running stale, and wait for them
+    //
+
+    ++reloadGeneration;
+
+    for (std::future<void>& reload : reloads)
+    {
+        reload.wait();
+    }
+
+    reloads.clear();
 
+    delete gPendingConfigs.exchange(nullptr);
+}
+
+void AHBot_WorldScript::SwapConfigs(AHBConfigSet* configs)
+{
     //
-    // Initialize the configuration (done only once at startup)
+    // Clear the bots array; this way they wont be used anymore while the configuration changes.
     //
 
-    gAllianceConfig->Initialize(gBotsId);
-    gHordeConfig->Initialize   (gBotsId);
-    gNeutralConfig->Initialize (gBotsId);
+    DeleteBots();
+
+    gPlanner.Stop();
 
     //
-    // Starts the bots
+    // Replace the configuration, the old one goes away with the set
+    //
+
+    std::swap(gBotsId        , configs->botsIds);
+    std::swap(gAllianceConfig, configs->allianceConfig);
+    std::swap(gHordeConfig   , configs->hordeConfig);
+    std::swap(gNeutralConfig , configs->neutralConfig);
+
+    //
+    // Keep the market prices learned so far
+    //
+
+    gAllianceConfig->TakeItemStats(configs->allianceConfig);
+    gHordeConfig->TakeItemStats   (configs->hordeConfig);
+    gNeutralConfig->TakeItemStats (configs->neutralConfig);
+
+    delete configs;
+
+    //
+    // The auctions are only read from the world thread
+    //
+
+    gAllianceConfig->InitializeAuctions(gBotsId);
+    gHordeConfig->InitializeAuctions   (gBotsId);
+    gNeutralConfig->InitializeAuctions (gBotsId);
+
+    //
+    // Start again the bots
     //
 
     PopulateBots();
+
+    gPlanner.Start(gAllianceConfig, gHordeConfig, gNeutralConfig);
+
+    LOG_INFO("module", "AHBot: Reloaded configuration applied");
 }
 
 void AHBot_WorldScript::DeleteBots()
@@ -155,10 +321,11 @@ void AHBot_WorldScript::DeleteBots()
     }
 
     //
-    // Clear the bot list
+    // Clear the bot list and their scheduled operations
     //
 
     gBots.clear();
+    gScheduler.Clear();
 
     // 
     // Free the resources used up by the old bots
@@ -188,4 +355,6 @@ void AHBot_WorldScript::PopulateBots()
 
         gBots.insert(bot);
     }
+
+    gScheduler.Start(gBots);
 }
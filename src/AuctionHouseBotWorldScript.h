@@ -5,8 +5,15 @@
 #ifndef AUCTION_HOUSE_BOT_WORLD_SCRIPT_H
 #define AUCTION_HOUSE_BOT_WORLD_SCRIPT_H
 
+#include <atomic>
+#include <future>
+#include <set>
+#include <vector>
+
 #include "ScriptMgr.h"
 
+struct AHBConfigSet;
+
 // =============================================================================
 // Interaction with the world core mechanisms
 // =============================================================================
@@ -14,6 +21,19 @@
 class AHBot_WorldScript : public WorldScript
 {
 private:
+    //
+    // Background reloads of the configuration; only the one of the latest generation is applied
+    //
+
+    std::vector<std::future<void>> reloads;
+
+    static std::atomic<uint32> reloadGeneration;
+
+    static bool LoadBotsIds(std::set<uint32>& botsIds);
+    static void BuildConfigs(uint32 generation);
+    static bool IsStale(uint32 generation);
+
+    void SwapConfigs(AHBConfigSet* configs);
     void DeleteBots();
     void PopulateBots();
 
@@ -22,6 +42,8 @@ public:
 
     void OnBeforeConfigLoad(bool reload) override;
     void OnStartup() override;
+    void OnUpdate(uint32 diff) override;
+    void OnShutdown() override;
 };
 
 #endif /* AUCTION_HOUSE_BOT_WORLD_SCRIPT_H */
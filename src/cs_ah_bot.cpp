@@ -22,10 +22,19 @@ Comment: All ah_bot related commands
 Category: commandscripts
 EndScriptData */
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+
 #include "ScriptMgr.h"
 #include "Chat.h"
 #include "AuctionHouseBot.h"
+#include "AuctionHouseBotPlanner.h"
 #include "Config.h"
+#include "DatabaseEnv.h"
+#include "Random.h"
 
 #if AC_COMPILER == AC_COMPILER_GNU
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -80,6 +89,207 @@ private:
         return static_cast<ItemQualities>(-1); // Invalid
     }
 
+    static AHBConfig* getConfig(uint32 ahMapID)
+    {
+        switch (ahMapID)
+        {
+            case 2:
+                return gAllianceConfig;
+            case 6:
+                return gHordeConfig;
+            default:
+                return gNeutralConfig;
+        }
+    }
+
+    static void HandleBenchmark(ChatHandler* handler, AHBConfig* config, uint32 picks)
+    {
+        //
+        // Time the random selection from every non empty bin, smallest first, the way the seller does it now and
+        // the way it used to: a copy of a std::set bin walked to a random index. The old way costs a copy and a
+        // walk per pick, so it is only timed over a cycle worth of picks.
+        //
+
+        static char const* names[AHB_CATEGORIES] =
+        {
+            "grey   trade goods", "white  trade goods", "green  trade goods", "blue   trade goods",
+            "purple trade goods", "orange trade goods", "yellow trade goods",
+            "grey   items", "white  items", "green  items", "blue   items",
+            "purple items", "orange items", "yellow items"
+        };
+
+        std::vector<uint32> categories;
+
+        for (uint32 category = 0; category < AHB_CATEGORIES; ++category)
+        {
+            if (config->Catalog->GetCount(category) > 0)
+            {
+                categories.push_back(category);
+            }
+        }
+
+        std::sort(categories.begin(), categories.end(), [config](uint32 a, uint32 b)
+        {
+            return config->Catalog->GetCount(a) < config->Catalog->GetCount(b);
+        });
+
+        uint32 setPicks = std::min<uint32>(picks, config->ItemsPerCycle > 0 ? config->ItemsPerCycle : 200);
+
+        for (uint32 category : categories)
+        {
+            uint32 count    = config->Catalog->GetCount(category);
+            uint64 checksum = 0;
+
+            //
+            // Current catalog: one random row
+            //
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (uint32 i = 0; i < picks; ++i)
+            {
+                checksum += config->Catalog->GetItemId(config->Catalog->GetRandomRow(category));
+            }
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            //
+            // Former bins: the set is passed by value, then walked
+            //
+
+            std::set<uint32> bin;
+
+            for (uint32 row : config->Catalog->GetRows(category))
+            {
+                bin.insert(config->Catalog->GetItemId(row));
+            }
+
+            start = std::chrono::steady_clock::now();
+
+            for (uint32 i = 0; i < setPicks; ++i)
+            {
+                std::set<uint32> copy = bin;
+
+                std::set<uint32>::iterator it = copy.begin();
+                std::advance(it, urand(0, uint32(copy.size()) - 1));
+
+                checksum += *it;
+            }
+
+            auto setElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            handler->PSendSysMessage("{}: {} items, catalog {} ns/pick ({} picks), set {} ns/pick ({} picks) (checksum {})", names[category], count, uint64(elapsed) / picks, picks, uint64(setElapsed) / setPicks, setPicks, checksum);
+        }
+    }
+
+    static void HandleSqlBenchmark(ChatHandler* handler, AHBConfig* config, uint32 updates)
+    {
+        //
+        // Time the bid update of the buyer, bound to the core prepared statement and formatted as it used to be.
+        // Both write back the current bidder and bid of an auction of the house, so nothing changes; they are run
+        // synchronously to measure the round trips, which blocks the world thread: use it on a test server.
+        //
+
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
+
+        if (auctionHouse->GetAuctionsBegin() == auctionHouse->GetAuctionsEnd())
+        {
+            handler->PSendSysMessage("No auction to update in auction house {}", config->GetAHID());
+            return;
+        }
+
+        AuctionEntry* auction = auctionHouse->GetAuctionsBegin()->second;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32 i = 0; i < updates; ++i)
+        {
+            CharacterDatabasePreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AUCTION_BID);
+
+            stmt->SetData(0, auction->bidder.GetCounter());
+            stmt->SetData(1, auction->bid);
+            stmt->SetData(2, auction->Id);
+
+            CharacterDatabase.DirectExecute(stmt);
+        }
+
+        auto prepared = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+
+        for (uint32 i = 0; i < updates; ++i)
+        {
+            CharacterDatabase.DirectExecute("UPDATE auctionhouse SET buyguid = '{}', lastbid = '{}' WHERE id = '{}'", auction->bidder.GetCounter(), auction->bid, auction->Id);
+        }
+
+        auto formatted = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        handler->PSendSysMessage("Bid update of auction {}: prepared {} us/update, formatted {} us/update ({} updates)", auction->Id, uint64(prepared) / updates, uint64(formatted) / updates, updates);
+    }
+
+    static void HandleVerify(ChatHandler* handler, AHBConfig* config)
+    {
+        //
+        // Count the auctions of the bots with a full scan and compare them with the counters kept by the hooks
+        //
+
+        std::map<uint32, uint32> auctions;
+        std::map<uint64, uint32> listings;
+        uint32                   total = 0;
+
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAHFID());
+
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctionsBegin(); itr != auctionHouse->GetAuctionsEnd(); ++itr)
+        {
+            AuctionEntry* Aentry = itr->second;
+            uint32        owner  = Aentry->owner.GetCounter();
+
+            if (gBotsId.find(owner) == gBotsId.end())
+            {
+                continue;
+            }
+
+            auctions[owner]++;
+            listings[(uint64(owner) << 32) | Aentry->item_template]++;
+            total++;
+        }
+
+        uint32 mismatches = 0;
+
+        for (uint32 botId : gBotsId)
+        {
+            uint32 scanned = auctions.count(botId) ? auctions[botId] : 0;
+            uint32 counted = config->GetBotAuctions(botId);
+
+            if (scanned != counted)
+            {
+                handler->PSendSysMessage("Bot {}: {} auctions found, {} counted", botId, scanned, counted);
+                mismatches++;
+            }
+        }
+
+        for (std::map<uint64, uint32>::const_iterator itr = listings.begin(); itr != listings.end(); ++itr)
+        {
+            uint32 botId   = uint32(itr->first >> 32);
+            uint32 itemId  = uint32(itr->first & 0xFFFFFFFF);
+            uint32 counted = config->GetBotListings(botId, itemId);
+
+            if (itr->second != counted)
+            {
+                handler->PSendSysMessage("Bot {}, item {}: {} auctions found, {} counted", botId, itemId, itr->second, counted);
+                mismatches++;
+            }
+        }
+
+        if (total != config->GetBotAuctions())
+        {
+            handler->PSendSysMessage("House {}: {} bot auctions found, {} counted", config->GetAHID(), total, config->GetBotAuctions());
+            mismatches++;
+        }
+
+        handler->PSendSysMessage("House {}: {} auctions, {} of the bots, {} mismatches", config->GetAHID(), auctionHouse->Getcount(), total, mismatches);
+    }
+
 public:
     ah_bot_commandscript() : CommandScript("ah_bot_commandscript")
     {
@@ -147,6 +357,8 @@ public:
                 bot->Commands(AHBotCommand::seller, 0, 0, param1);
             }
 
+            gPlanner.Refresh();
+
             return true;
         }
         else if (strncmp(opt, "usemarketprice", l) == 0)
@@ -221,6 +433,9 @@ public:
             handler->PSendSysMessage("buyerprice - set the buyer price policy");
             handler->PSendSysMessage("bidinterval - set the bid interval for buyer");
             handler->PSendSysMessage("bidsperinterval - set the bid amount for buyer");
+            handler->PSendSysMessage("benchmark - compare the random item selection of the seller with the former set bins, by bin size");
+            handler->PSendSysMessage("verify - compare the bot auction counters with the auction house");
+            handler->PSendSysMessage("sqlbenchmark - compare the prepared and the formatted bid update, blocking the world thread");
 
             return true;
         }
@@ -372,6 +587,8 @@ public:
                 {
                     bot->Commands(AHBotCommand::minprice, ahMapID, quality, param2);
                 }
+
+                gPlanner.Refresh();
             }
             else
             {
@@ -398,6 +615,8 @@ public:
                 {
                     bot->Commands(AHBotCommand::maxprice, ahMapID, quality, param2);
                 }
+
+                gPlanner.Refresh();
             }
             else
             {
@@ -432,6 +651,8 @@ public:
                 {
                     bot->Commands(AHBotCommand::minbidprice, ahMapID, quality, param2);
                 }
+
+                gPlanner.Refresh();
             }
             else
             {
@@ -466,6 +687,8 @@ public:
                 {
                     bot->Commands(AHBotCommand::maxbidprice, ahMapID, quality, param2);
                 }
+
+                gPlanner.Refresh();
             }
             else
             {
@@ -499,6 +722,8 @@ public:
                 {
                     bot->Commands(AHBotCommand::maxstack, ahMapID, quality, param2);
                 }
+
+                gPlanner.Refresh();
             }
             else
             {
@@ -562,6 +787,54 @@ public:
                 bot->Commands(AHBotCommand::bidsperinterval, ahMapID, 0, param1);
             }
         }
+        else if (strncmp(opt, "benchmark", l) == 0)
+        {
+            char* param1 = strtok(NULL, " ");
+
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions benchmark $ahMapID (2, 6 or 7) [$picks]");
+                return false;
+            }
+
+            uint32 picks = param1 ? uint32(strtoul(param1, NULL, 0)) : 100000;
+
+            if (picks == 0)
+            {
+                picks = 100000;
+            }
+
+            HandleBenchmark(handler, getConfig(ahMapID), picks);
+        }
+        else if (strncmp(opt, "verify", l) == 0)
+        {
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions verify $ahMapID (2, 6 or 7)");
+                return false;
+            }
+
+            HandleVerify(handler, getConfig(ahMapID));
+        }
+        else if (strncmp(opt, "sqlbenchmark", l) == 0)
+        {
+            char* param1 = strtok(NULL, " ");
+
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions sqlbenchmark $ahMapID (2, 6 or 7) [$updates]");
+                return false;
+            }
+
+            uint32 updates = param1 ? uint32(strtoul(param1, NULL, 0)) : 1000;
+
+            if (updates == 0)
+            {
+                updates = 1000;
+            }
+
+            HandleSqlBenchmark(handler, getConfig(ahMapID), updates);
+        }
         else
         {
             handler->PSendSysMessage("Invalid syntax");